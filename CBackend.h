@@ -0,0 +1,180 @@
+/*
+C 后端（提前编译）
+把校验通过的Pcode翻译为一个独立的C源文件，用系统C编译器（如 cc -O2）编译后即为本机程序
+每个过程一个C函数，ID区为函数内的局部数组，外层变量经静态链访问
+操作数栈各单元的深度已由校验确定，翻译为函数内的局部变量 s0、s1...，由C编译器分配寄存器
+read、write 使用文件开头的小运行时，输出格式与解释器相同
+*/
+
+#pragma once
+#include<iostream>
+#include<fstream>
+#include<sstream>
+#include<vector>
+#include<string>
+#include"Pcode.h"
+#include"DebugInfo.h"
+
+using namespace std;
+
+class CBackend {
+public:
+	// 翻译为C源文件，pcode须已通过verify
+	bool emit(const Pcode& pcode, const DebugInfo& dbg, const string& file) {
+		const vector<Ins>& code = pcode.code;
+		int n = code.size();
+		int procCount = dbg.procs.size();
+
+		// 各过程的指令（按地址），跳转目标处需要标号
+		vector<vector<int>> owned(procCount);
+		for (int i = 0; i < n; i++) {
+			if (pcode.procOf[i] >= 0) owned[pcode.procOf[i]].push_back(i);
+		}
+		vector<bool> target(n + 1, false);
+		for (int k = 0; k < procCount; k++) {
+			const vector<int>& list = owned[k];
+			for (size_t j = 0; j < list.size(); j++) {
+				const Ins& ins = code[list[j]];
+				if (ins.f == op::JMP || ins.f == op::JPC || isCmpJump(ins.f)) target[ins.A] = true;
+				//顺序执行的下一条不紧接在后面时也需要标号
+				bool fall = ins.f != op::JMP && ins.f != op::RET;
+				int next = j + 1 < list.size() ? list[j + 1] : -1;
+				if (fall && next != list[j] + 1) target[list[j] + 1] = true;
+			}
+			if (!list.empty() && list[0] != dbg.procs[k].entry) target[dbg.procs[k].entry] = true;
+		}
+
+		ostringstream out;
+		out << "/* 由PL/0编译器生成，主程序 " << dbg.procs[0].name << " */\n"
+			<< "#include <stdio.h>\n#include <stdlib.h>\n#include <limits.h>\n\n"
+			<< "typedef struct Frame { struct Frame* sl; int* v; } Frame; /* 静态链、ID区 */\n\n"
+			<< "static inline void pl0_fail(const char* msg) {\n"
+			<< "\tfflush(stdout);\n"
+			<< "\tfprintf(stderr, \"运行时错误：%s\\n\", msg);\n"
+			<< "\texit(1);\n}\n"
+			<< "static inline int pl0_read(void) {\n"
+			<< "\tint v;\n"
+			<< "\tif (scanf(\"%d\", &v) != 1) pl0_fail(feof(stdin) ? \"输入已结束\" : \"输入格式错误\");\n"
+			<< "\treturn v;\n}\n"
+			<< "static inline void pl0_write(int v) { printf(\"输出: %d\\n\", v); }\n"
+			<< "static inline int pl0_div(int a, int b) {\n"
+			<< "\tif (b == 0) pl0_fail(\"除以零\");\n"
+			<< "\tif (a == INT_MIN && b == -1) pl0_fail(\"除法溢出\");\n"
+			<< "\treturn a / b;\n}\n"
+			<< "/* 加减乘按二进制补码回绕，与解释器一致 */\n"
+			<< "#define ADD(a, b) ((int)((unsigned)(a) + (unsigned)(b)))\n"
+			<< "#define SUB(a, b) ((int)((unsigned)(a) - (unsigned)(b)))\n"
+			<< "#define MUL(a, b) ((int)((unsigned)(a) * (unsigned)(b)))\n\n";
+
+		for (int k = 0; k < procCount; k++) {
+			out << "static void p" << k << "(Frame* sl, const int* arg);\n";
+		}
+		out << "\n";
+
+		for (int k = 0; k < procCount; k++) {
+			const ProcInfo& proc = dbg.procs[k];
+			int args = 0;//本过程调用其他过程时的实参个数
+			for (int i : owned[k]) {
+				if (code[i].f == op::STO && code[i].L == -1) args = max(args, code[i].A + 1);
+			}
+
+			out << "/* " << proc.name << " */\n"
+				<< "static void p" << k << "(Frame* sl, const int* arg) {\n"
+				<< "\tint v[" << max(1, proc.id_count) << "] = { 0 };\n"
+				<< "\tFrame f = { sl, v };\n";
+			if (args > 0) out << "\tint a[" << args << "] = { 0 };\n";
+			for (int d = 0; d < pcode.maxStack[k]; d++) out << (d == 0 ? "\tint s0" : ", s" + to_string(d));
+			if (pcode.maxStack[k] > 0) out << ";\n";
+			for (int p = 0; p < proc.param_count; p++) out << "\tv[" << p << "] = arg[" << p << "];\n";
+			out << "\t(void)f;\n";
+			if (!owned[k].empty() && owned[k][0] != proc.entry) out << "\tgoto L" << proc.entry << ";\n";
+
+			const vector<int>& list = owned[k];
+			for (size_t j = 0; j < list.size(); j++) {
+				int i = list[j];
+				if (target[i]) out << "L" << i << ":\n";
+				Ins ins = code[i];
+				if (isSuper(ins.f)) ins.f = superHead(ins.f);//操作数指令仍在原处，逐条翻译
+				out << "\t" << statement(ins, pcode.stackDepth[i], proc, dbg, pcode) << "\n";
+				bool fall = ins.f != op::JMP && ins.f != op::RET;
+				int next = j + 1 < list.size() ? list[j + 1] : -1;
+				if (fall && next != i + 1) out << "\tgoto L" << i + 1 << ";\n";
+			}
+			out << "}\n\n";
+		}
+
+		out << "int main(void) {\n"
+			<< "\tp0(NULL, NULL);\n"
+			<< "\tprintf(\"程序结束\\n\");\n"
+			<< "\treturn 0;\n}\n";
+
+		ofstream ofs(file, ios::out | ios::binary);
+		if (!ofs.is_open()) {
+			cerr << file << " can't open" << endl;
+			return false;
+		}
+		ofs << out.str();
+		cout << "C源文件已输出到文件," << file << endl;
+		return true;
+	}
+
+private:
+	static string slot(int d) { return "s" + to_string(d); }
+
+	// L层第A个变量：本层为v[A]，外层沿静态链
+	static string var(int L, int A, const ProcInfo& proc) {
+		if (L == proc.level) return "v[" + to_string(A) + "]";
+		string s = "f.sl";
+		for (int k = proc.level - 1; k > L; k--) s += "->sl";
+		return s + "->v[" + to_string(A) + "]";
+	}
+
+	static string cmpOp(op f) {
+		switch (f) {
+		case op::EQ: return "==";
+		case op::NE: return "!=";
+		case op::LT: return "<";
+		case op::LE: return "<=";
+		case op::GT: return ">";
+		default: return ">=";
+		}
+	}
+
+	// 一条指令对应的C语句，d为执行前栈深度
+	static string statement(const Ins& ins, int d, const ProcInfo& proc, const DebugInfo& dbg, const Pcode& pcode) {
+		string A = to_string(ins.A);
+		switch (ins.f) {
+		case op::LIT: return slot(d) + " = " + A + ";";
+		case op::LOD: return slot(d) + " = " + var(ins.L, ins.A, proc) + ";";
+		case op::STO:
+			if (ins.L == -1) return "a[" + A + "] = " + slot(d - 1) + ";";
+			return var(ins.L, ins.A, proc) + " = " + slot(d - 1) + ";";
+		case op::CAL:
+		{
+			const ProcInfo* callee = pcode.entryProc[ins.A];
+			int k = callee - dbg.procs.data();
+			// 被调过程的静态链指向其直接外层过程（callee.level-1层）的活动记录
+			string sl = "&f";
+			for (int lv = proc.level; lv > callee->level - 1; lv--) sl = lv == proc.level ? "f.sl" : sl + "->sl";
+			return "p" + to_string(k) + "(" + sl + ", " + (callee->param_count > 0 ? "a" : "NULL") + ");";
+		}
+		case op::INT: return ";";
+		case op::JMP: return "goto L" + A + ";";
+		case op::JPC: return "if (!" + slot(d - 1) + ") goto L" + A + ";";
+		case op::RED: return slot(d) + " = pl0_read();";
+		case op::WRT: return "pl0_write(" + slot(d - 1) + ");";
+		case op::RET: return "return;";
+		case op::NEG: return slot(d - 1) + " = SUB(0, " + slot(d - 1) + ");";
+		case op::ODD: return slot(d - 1) + " = " + slot(d - 1) + " % 2;";
+		case op::DUP: return slot(d) + " = " + slot(d - 1) + ";";
+		case op::ADD: return slot(d - 2) + " = ADD(" + slot(d - 2) + ", " + slot(d - 1) + ");";
+		case op::SUB: return slot(d - 2) + " = SUB(" + slot(d - 2) + ", " + slot(d - 1) + ");";
+		case op::MUL: return slot(d - 2) + " = MUL(" + slot(d - 2) + ", " + slot(d - 1) + ");";
+		case op::DIV: return slot(d - 2) + " = pl0_div(" + slot(d - 2) + ", " + slot(d - 1) + ");";
+		case op::EQ: case op::NE: case op::LT: case op::LE: case op::GT: case op::GE:
+			return slot(d - 2) + " = " + slot(d - 2) + " " + cmpOp(ins.f) + " " + slot(d - 1) + ";";
+		default://JPC系列：比较不成立时跳转
+			return "if (!(" + slot(d - 2) + " " + cmpOp(jumpCmp(ins.f)) + " " + slot(d - 1) + ")) goto L" + A + ";";
+		}
+	}
+};
@@ -0,0 +1,277 @@
+/*
+调试信息旁路文件
+与 pcode.txt 一同输出：过程入口表、活动记录布局（形参/变量名及偏移）、源码行号映射
+解释器只依赖该文件即可运行已编译的程序，无需内存中的符号表
+*/
+
+#pragma once
+#include<fstream>
+#include<iostream>
+#include<string>
+#include<vector>
+#include<unordered_map>
+#include<cstdint>
+#include<cstring>
+#include"SymbolTable.h"
+#include"config.h"
+
+using namespace std;
+
+// 源码位置
+struct SrcPos {
+	int row = 0;
+	int column = 0;
+};
+
+// 过程信息（一个过程对应一种活动记录布局）
+struct ProcInfo {
+	string name = "";       // 过程名，主程序为program名
+	int entry = 0;          // pcode入口地址
+	int level = 0;          // 过程体所在层
+	int parent = -1;        // 直接外层过程在procs中的下标，主程序为-1
+	int param_count = 0;    // 形参个数
+	int id_count = 0;       // ID个数：形参+变量
+	vector<string> ids;     // ID区各单元名称，下标即偏移（先形参后变量）
+};
+
+/*旁路文件格式（小端，int32）
+magic "PL0D" | version
+布局：过程个数 | 每个过程：entry level parent param_count id_count
+名字：每个过程：名字 ID名字*id_count | 行号个数 | 每条指令：row column
+字符串：长度 + 字节
+二进制映像中布局和名字分别作为过程表节和调试节
+*/
+class DebugInfo {
+public:
+	static const uint32_t VERSION = 2;
+
+	vector<ProcInfo> procs;   // procs[0] 为主程序
+	vector<SrcPos> lines;     // 下标为pcode地址
+
+	// 由符号表和代码生成时记录的行号构造
+	void build(SymbolTable& symTable, const vector<SrcPos>& codeLines) {
+		procs.clear();
+		lines = codeLines;
+
+		//层序遍历所有过程层，主程序层在最前；元素为（层，入口地址，外层过程下标）
+		struct Item { SymLayer* layer; int entry; int parent; };
+		vector<Item> layers;
+		layers.push_back({ symTable.first_layer_, 0, -1 });
+		while (!layers.empty()) {
+			Item item = layers.front();
+			SymLayer* layer = item.layer;
+			layers.erase(layers.begin());
+			if (layer == nullptr) continue;
+			if (item.entry < 0) continue;//已被死代码消除删除的过程（其内层过程也不可达）
+
+			Symbol* sym = layer->sym_head_;
+			while (sym != nullptr) {
+				if (sym->getType() == SYMBOLTYPE::PROC && sym->attr_.proc_attr.layer_ptr != nullptr) {
+					layers.push_back({ sym->attr_.proc_attr.layer_ptr, sym->getProcEntryAddr(), (int)procs.size() });
+				}
+				sym = sym->getNext();
+			}
+
+			ProcInfo p;
+			p.name = layer->getLayerName();
+			p.entry = item.entry;
+			p.parent = item.parent;
+			p.level = layer->getLevel();
+			p.param_count = layer->getParamCount();
+			p.id_count = layer->getVarOffset();
+			p.ids.assign(p.id_count, "");
+
+			sym = layer->sym_head_;
+			while (sym != nullptr) {
+				SYMBOLTYPE ty = sym->getType();
+				if (ty == SYMBOLTYPE::VAR || ty == SYMBOLTYPE::PARAM) {
+					int offset = sym->getOffset();
+					if (offset >= 0 && offset < p.id_count) p.ids[offset] = sym->getName();
+				}
+				sym = sym->getNext();
+			}
+			procs.push_back(p);
+		}
+		index();
+	}
+
+	// 按入口地址查找过程，未找到返回nullptr
+	const ProcInfo* findByEntry(int entry) const {
+		auto it = entryIndex.find(entry);
+		if (it == entryIndex.end()) return nullptr;
+		return &procs[it->second];
+	}
+
+	SrcPos posOf(int pc) const {
+		if (pc < 0 || pc >= (int)lines.size()) return SrcPos();
+		return lines[pc];
+	}
+
+	bool save(const string& file) const {
+		string buf;
+		write(buf);
+
+		ofstream ofs(file, ios::out | ios::binary);
+		if (!ofs.is_open()) {
+			cerr << file << " can't open" << endl;
+			return false;
+		}
+		ofs.write(buf.data(), buf.size());
+		return true;
+	}
+
+	// 一次读入整个文件后解析
+	bool load(const string& file) {
+		ifstream ifs(file, ios::in | ios::binary | ios::ate);
+		if (!ifs.is_open()) {
+			cerr << "无法打开调试信息文件: " << file << endl;
+			return false;
+		}
+		streamsize size = ifs.tellg();
+		ifs.seekg(0);
+		string buf(size, '\0');
+		if (!ifs.read(&buf[0], size)) {
+			cerr << "读取调试信息文件失败: " << file << endl;
+			return false;
+		}
+		size_t pos = 0;
+		if (!read(buf, pos)) {
+			cerr << "调试信息文件格式错误: " << file << endl;
+			return false;
+		}
+		return true;
+	}
+
+	// 按旁路文件格式追加到buf
+	void write(string& buf) const {
+		buf.append("PL0D", 4);
+		putInt(buf, VERSION);
+		writeLayout(buf);
+		writeNames(buf);
+	}
+
+	// 从buf的pos处解析，成功时pos移到末尾
+	bool read(const string& buf, size_t& pos) {
+		int32_t version = 0;
+		bool ok = buf.compare(pos, 4, "PL0D") == 0;
+		pos += 4;
+		ok = ok && getInt(buf, pos, version) && version == (int32_t)VERSION;
+		return ok && readLayout(buf, pos) && readNames(buf, pos);
+	}
+
+	// 过程布局：解释器运行必需的部分
+	void writeLayout(string& buf) const {
+		putInt(buf, (int)procs.size());
+		for (const ProcInfo& p : procs) {
+			putInt(buf, p.entry);
+			putInt(buf, p.level);
+			putInt(buf, p.parent);
+			putInt(buf, p.param_count);
+			putInt(buf, p.id_count);
+		}
+	}
+	bool readLayout(const string& buf, size_t& pos) {
+		procs.clear();
+		lines.clear();
+		int32_t n = 0;
+		bool ok = getInt(buf, pos, n) && n > 0;
+		for (int i = 0; ok && i < n; i++) {
+			ProcInfo p;
+			int32_t v[5];
+			for (int k = 0; ok && k < 5; k++) ok = getInt(buf, pos, v[k]);
+			ok = ok && v[2] >= -1 && v[2] < i && (v[2] == -1) == (i == 0) && v[3] >= 0 && v[4] >= v[3];
+			//层为外层过程的层+1（主程序为0），display按层下标；ID区连同头部须放得进数据栈，否则不可能执行，也不按其分配名字表
+			ok = ok && v[1] == (i == 0 ? 0 : procs[v[2]].level + 1) && v[4] <= stack_size - 4;
+			if (!ok) break;
+			p.entry = v[0];
+			p.level = v[1];
+			p.parent = v[2];
+			p.param_count = v[3];
+			p.id_count = v[4];
+			p.name = "proc@" + to_string(p.entry);
+			p.ids.assign(p.id_count, "");
+			procs.push_back(p);
+		}
+		if (!ok) {
+			procs.clear();
+			return false;
+		}
+		index();
+		return true;
+	}
+
+	// 名字和行号：只用于跟踪、剖析等显示
+	void writeNames(string& buf) const {
+		for (const ProcInfo& p : procs) {
+			putStr(buf, p.name);
+			for (const string& id : p.ids) putStr(buf, id);
+		}
+		putInt(buf, (int)lines.size());
+		for (const SrcPos& s : lines) {
+			putInt(buf, s.row);
+			putInt(buf, s.column);
+		}
+	}
+	bool readNames(const string& buf, size_t& pos) {
+		bool ok = true;
+		for (int i = 0; ok && i < (int)procs.size(); i++) {
+			ProcInfo& p = procs[i];
+			ok = getStr(buf, pos, p.name);
+			for (int k = 0; ok && k < p.id_count; k++) ok = getStr(buf, pos, p.ids[k]);
+		}
+		int32_t n = 0;
+		ok = ok && getInt(buf, pos, n) && n >= 0;
+		lines.clear();
+		for (int i = 0; ok && i < n; i++) {
+			SrcPos s;
+			ok = getInt(buf, pos, s.row) && getInt(buf, pos, s.column);
+			lines.push_back(s);
+		}
+		if (!ok) {
+			procs.clear();
+			lines.clear();
+		}
+		return ok;
+	}
+
+private:
+	unordered_map<int, int> entryIndex; // 入口地址 -> procs下标
+
+	void index() {
+		entryIndex.clear();
+		for (int i = 0; i < (int)procs.size(); i++) {
+			entryIndex[procs[i].entry] = i;
+		}
+	}
+
+	static void putInt(string& buf, int32_t v) {
+		char b[4];
+		memcpy(b, &v, 4);
+		buf.append(b, 4);
+	}
+	static void putStr(string& buf, const string& s) {
+		putInt(buf, (int32_t)s.size());
+		buf.append(s);
+	}
+	static bool getInt(const string& buf, size_t& pos, int32_t& v) {
+		if (pos + 4 > buf.size()) return false;
+		memcpy(&v, buf.data() + pos, 4);
+		pos += 4;
+		return true;
+	}
+	static bool getStr(const string& buf, size_t& pos, string& s) {
+		int32_t len = 0;
+		if (!getInt(buf, pos, len) || len < 0 || pos + len > buf.size()) return false;
+		s.assign(buf.data() + pos, len);
+		pos += len;
+		return true;
+	}
+};
+
+// pcode文件对应的旁路文件名：pcode.txt -> pcode.dbg
+string debugFileOf(const string& codeFile) {
+	size_t dot = codeFile.find_last_of('.');
+	size_t slash = codeFile.find_last_of("/\\");
+	if (dot == string::npos || (slash != string::npos && dot < slash)) return codeFile + ".dbg";
+	return codeFile.substr(0, dot) + ".dbg";
+}
@@ -0,0 +1,220 @@
+/*
+解释器输入输出
+write 的值经缓冲区成块写出，不再在程序结束时统一输出，长时间运行的程序内存不随输出增长
+read 从大块缓冲区中直接解析整数，格式错误时报告行列位置
+*/
+
+#pragma once
+#include<cstdio>
+#include<climits>
+#include<iostream>
+#include<string>
+#include<cstring>
+#include"config.h"
+
+using namespace std;
+
+/*
+输出缓冲区
+默认写到标准输出，每个值一行"输出: 值"；-out=文件 时写到文件（可为命名管道），每个值一行只有数值
+缓冲区超过 out_flush 字节时写出，read 等待输入前和程序结束时也写出
+*/
+class OutSink {
+public:
+	~OutSink() { close(); }
+
+	bool open(const string& file) {
+		close();
+		if (file.empty()) {
+			fp = stdout;
+			prefix = "输出: ";
+		}
+		else {
+			fp = fopen(file.c_str(), "wb");
+			if (fp == nullptr) {
+				cerr << "无法打开输出文件: " << file << endl;
+				return false;
+			}
+			prefix.clear();
+		}
+		buf.clear();
+		buf.reserve(out_flush + 64);
+		return true;
+	}
+
+	void put(int v) {
+		char num[16];
+		int n = snprintf(num, sizeof(num), "%d\n", v);
+		buf.append(prefix);
+		buf.append(num, n);
+		if (buf.size() >= (size_t)out_flush) flush();
+	}
+
+	void flush() {
+		if (fp == nullptr) return;
+		if (!buf.empty()) {
+			fwrite(buf.data(), 1, buf.size(), fp);
+			buf.clear();
+		}
+		fflush(fp);
+	}
+
+	void close() {
+		flush();
+		if (fp != nullptr && fp != stdout) fclose(fp);
+		fp = nullptr;
+	}
+
+private:
+	FILE* fp = nullptr;
+	string buf;
+	string prefix;
+};
+
+OutSink output;//write 输出
+
+bool runtime_failed = false;//执行中发生了运行时错误，main 据此返回非零退出码
+
+// 报告运行时错误：先写出已缓冲的输出，错误信息才会排在出错前的输出之后
+void runtimeError(const string& msg) {
+	output.flush();
+	cerr << "运行时错误：" << msg << endl;
+	runtime_failed = true;
+}
+
+/*
+输入缓冲区
+-in=文件 时按块读取文件，-in=- 时按块读取标准输入（用于管道，不提示）
+否则交互读标准输入，按行读取以免阻塞
+只有缓冲区读完、确实需要等待输入时才提示"等待输入："，同一行的多个值只提示一次
+整数之间以空白分隔，可带正负号
+*/
+class InSource {
+public:
+	~InSource() { close(); }
+
+	bool open(const string& file) {
+		close();
+		if (file.empty() || file == "-") {
+			fp = stdin;
+		}
+		else {
+			fp = fopen(file.c_str(), "rb");
+			if (fp == nullptr) {
+				cerr << "无法打开输入文件: " << file << endl;
+				return false;
+			}
+		}
+		interactive = file.empty();
+		buf.resize(BUF_SIZE);
+		pos = len = 0;
+		eof = false;
+		row = 1;
+		column = 1;
+		return true;
+	}
+
+	void close() {
+		if (fp != nullptr && fp != stdin) fclose(fp);
+		fp = nullptr;
+	}
+
+	// 读入下一个整数，输入结束或格式错误时输出错误位置并返回false
+	bool next(int& v) {
+		int c = peek();
+		while (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+			get();
+			c = peek();
+		}
+		if (c == EOF) {
+			runtimeError("输入已结束（第 " + to_string(row) + " 行），read 没有可读的值");
+			return false;
+		}
+
+		int startRow = row, startColumn = column;
+		string text;//出错时显示的内容
+		bool neg = false;
+		if (c == '+' || c == '-') {
+			neg = c == '-';
+			text += (char)get();
+			c = peek();
+		}
+		long long val = 0;
+		int digits = 0;
+		bool overflow = false;
+		while (c >= '0' && c <= '9') {
+			text += (char)get();
+			val = val * 10 + (c - '0');
+			overflow = overflow || val > (long long)INT_MAX + 1;
+			if (overflow) val = 0;
+			digits++;
+			c = peek();
+		}
+		if (digits == 0 || !(c == EOF || c == ' ' || c == '\t' || c == '\r' || c == '\n')) {
+			while (c != EOF && c != ' ' && c != '\t' && c != '\r' && c != '\n' && text.size() < 32) {
+				text += (char)get();
+				c = peek();
+			}
+			runtimeError("输入格式错误（第 " + to_string(startRow) + " 行第 " + to_string(startColumn) + " 列）：" + text);
+			return false;
+		}
+		if (neg) val = -val;
+		if (overflow || val > INT_MAX || val < INT_MIN) {
+			runtimeError("输入超出整数范围（第 " + to_string(startRow) + " 行第 " + to_string(startColumn) + " 列）：" + text);
+			return false;
+		}
+		v = (int)val;
+		return true;
+	}
+
+private:
+	static const size_t BUF_SIZE = 1 << 16;
+
+	FILE* fp = nullptr;
+	bool interactive = false; // 交互输入：按行读取并提示
+	string buf;
+	size_t pos = 0, len = 0;
+	bool eof = false;
+	int row = 1, column = 1;  // 下一个字符在输入中的位置
+
+	bool refill() {
+		if (eof || fp == nullptr) return false;
+		if (interactive) {
+			output.flush();
+			cout << "等待输入：" << endl;
+			if (fgets(&buf[0], BUF_SIZE, fp) == nullptr) {
+				eof = true;
+				return false;
+			}
+			len = strlen(buf.c_str());
+		}
+		else {
+			len = fread(&buf[0], 1, BUF_SIZE, fp);
+			if (len == 0) {
+				eof = true;
+				return false;
+			}
+		}
+		pos = 0;
+		return true;
+	}
+	int peek() {
+		if (pos == len && !refill()) return EOF;
+		return (unsigned char)buf[pos];
+	}
+	int get() {
+		int c = peek();
+		if (c == EOF) return c;
+		pos++;
+		if (c == '\n') {
+			row++;
+			column = 1;
+		}
+		else {
+			column++;
+		}
+		return c;
+	}
+};
+
+InSource input;//read 输入
@@ -0,0 +1,589 @@
+/*
+模板JIT
+把校验通过的Pcode逐条按固定模板翻译为x86-64机器码，写入mmap得到的可执行缓冲区后直接执行，没有取指和分派
+数据栈与解释器一样一次分配，栈顶、当前活动记录基址、display表等常驻寄存器；CAL/RET 用本机 call/ret
+read、write 及运行时错误回调C++运行时
+只在x86-64的类Unix系统上编译，其他平台或开启跟踪时改用解释器
+分层执行（-vm=tier）时由解释器在过程调用或循环回边处经入口桩转入，与解释器共用数据栈
+*/
+
+#pragma once
+#include<iostream>
+#include<vector>
+#include<string>
+#include<chrono>
+#include<cstdint>
+#include<cstring>
+#include<cstddef>
+#include"Pcode.h"
+#include"DebugInfo.h"
+#include"IO.h"
+#include"config.h"
+
+#if defined(__x86_64__) && !defined(_WIN32)
+#define PL0_JIT
+#include<sys/mman.h>
+#endif
+
+using namespace std;
+
+#ifdef PL0_JIT
+
+/*
+机器码执行时的上下文，r15指向它
+活动记录：[0..1] 动态链接（调用者基址，指针） [2..3] 被覆盖的display项（指针） [4..] 形参、变量 之后为操作数栈
+返回地址在本机栈上，活动记录头部仍为4个单元
+*/
+struct JitContext {
+	int* sp = nullptr;        // 栈顶（下一个空单元）
+	int* bp = nullptr;        // 当前活动记录基址
+	int* limit = nullptr;     // 数据栈末尾
+	int** display = nullptr;  // display[层] 为该层当前活动记录基址
+	int* args = nullptr;      // 新活动记录的实参（STO -1 A 写入 args[A]）
+	void* savedRsp = nullptr; // 进入机器码时的本机栈指针，出错时由此直接返回
+};
+
+// 机器码回调的运行时函数
+static int jitRead(int* val) {//返回0表示输入出错
+	return input.next(*val) ? 1 : 0;
+}
+static void jitWrite(int val) {
+	output.put(val);
+}
+static void jitDivZero() {
+	runtimeError("除以零");
+}
+static void jitDivOverflow() {
+	runtimeError("除法溢出");
+}
+static void jitOverflow() {
+	runtimeError("栈溢出（栈大小 " + to_string(stack_size) + "，可用 -stack=<单元数> 调整）");
+	exit(1);
+}
+
+class Jit {
+public:
+	string error;      // 翻译失败原因
+	size_t codeBytes = 0;
+
+	~Jit() {
+		if (mem != nullptr) munmap(mem, memSize);
+	}
+
+	// 翻译全部代码，成功后可调用run
+	bool compile(const Pcode& pcode, const DebugInfo& dbg) {
+		const vector<Ins>& code = pcode.code;
+		int n = code.size();
+		buf.clear();
+		label.assign(n, -1);
+		jumps.clear();
+
+		//参数缓冲区大小
+		argCount = 1;
+		for (const Ins& ins : code) {
+			if (ins.f == op::STO && ins.L == -1) argCount = max(argCount, ins.A + 1);
+		}
+
+		// 入口：从主程序开始执行
+		enter();
+		jmpTo(dbg.procs[0].entry);
+
+		// 出口均先恢复本机栈：出错返回1，主程序结束返回0，入口桩调用的过程返回后返回2
+		errorAt = buf.size();
+		movRI(RAX, 1);
+		int toExit = jmpRel();
+		endAt = buf.size();
+		movRI(RAX, 0);
+		int toExit2 = jmpRel();
+		returnAt = buf.size();
+		movRI(RAX, 2);
+		patch(toExit, buf.size());
+		patch(toExit2, buf.size());
+		movRM64(RSP, R15, offsetof(JitContext, savedRsp));
+		addRsp8();
+		pop(R15); pop(R14); pop(R13); pop(R12); pop(RBP); pop(RBX);
+		emit(0xC3);
+
+		for (int i = 0; i < n; i++) {
+			label[i] = buf.size();
+			Ins ins = code[i];
+			if (isSuper(ins.f)) ins.f = superHead(ins.f);//超级指令的操作数仍在原处，按普通指令逐条翻译
+			//所在过程（校验时已确定）用于判断LOD/STO是否访问本层、RET是否结束程序；不可达指令不翻译
+			if (pcode.procOf[i] < 0) continue;
+			if (!emitIns(ins, pcode.procOf[i], pcode, dbg)) {
+				error = "地址 " + to_string(i) + ": " + insText(code[i]) + " 无法翻译";
+				return false;
+			}
+		}
+		// 分层执行的入口桩：调用过程k（按CAL模板建立活动记录）；从rsi给出的循环头继续执行当前活动记录
+		callStub.assign(dbg.procs.size(), 0);
+		for (size_t k = 1; k < dbg.procs.size(); k++) {
+			callStub[k] = buf.size();
+			enter();
+			emitIns(Ins{ op::CAL, 0, dbg.procs[k].entry }, 0, pcode, dbg);
+			jmpAbs(returnAt);
+		}
+		osrStub = buf.size();
+		enter();
+		emit(0xFF); emit(0xD6);//call rsi
+		jmpAbs(returnAt);
+
+		for (auto& j : jumps) patch(j.first, label[j.second]);
+		codeBytes = buf.size();
+
+		// 复制到可执行内存：先可写，写完改为只读可执行
+		memSize = (buf.size() + 4095) & ~(size_t)4095;
+		void* p = mmap(nullptr, memSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED) {
+			error = "mmap 失败";
+			return false;
+		}
+		memcpy(p, buf.data(), buf.size());
+		if (mprotect(p, memSize, PROT_READ | PROT_EXEC) != 0) {
+			munmap(p, memSize);
+			error = "mprotect 失败";
+			return false;
+		}
+		mem = (uint8_t*)p;
+		return true;
+	}
+
+	// 执行机器码，与解释器相同的数据栈大小和输出格式
+	void run(const DebugInfo& dbg) {
+		int maxLevel = 0;
+		for (const ProcInfo& p : dbg.procs) maxLevel = max(maxLevel, p.level);
+		vector<int> stack(stack_size, 0);
+		vector<int*> display(maxLevel + 1, stack.data());
+		vector<int> args(argCount, 0);
+		const ProcInfo& mainProc = dbg.procs[0];
+		if (4 + mainProc.id_count > stack_size) {
+			runtimeError("栈溢出（栈大小 " + to_string(stack_size) + "，可用 -stack=<单元数> 调整）");
+			return;
+		}
+
+		JitContext ctx;
+		ctx.bp = stack.data();
+		ctx.sp = stack.data() + 4 + mainProc.id_count;
+		ctx.limit = stack.data() + stack.size();
+		ctx.display = display.data();
+		ctx.args = args.data();
+
+		auto start = chrono::steady_clock::now();
+		int (*entry)(JitContext*) = (int (*)(JitContext*))mem;
+		if (entry(&ctx) == 0) {
+			output.flush();
+			cout << "程序结束" << endl;
+		}
+		if (stats_mode) {
+			double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			cout << "JIT：机器码 " << codeBytes << " 字节，用时 " << sec << " 秒" << endl;
+		}
+	}
+
+	// 参数缓冲区单元数
+	int argSlots() const { return argCount; }
+
+	// 分层执行：调用下标为proc的过程，ctx为解释器当前的栈顶、活动记录和display
+	int callProc(int proc, JitContext* ctx) {
+		return ((int (*)(JitContext*))(mem + callStub[proc]))(ctx);
+	}
+	// 分层执行：当前活动记录（头部已为本机格式）从循环头pc起执行
+	int enterAt(int pc, JitContext* ctx) {
+		return ((int (*)(JitContext*, void*))(mem + osrStub))(ctx, mem + label[pc]);
+	}
+
+private:
+	enum Reg { RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7, R12 = 12, R13 = 13, R14 = 14, R15 = 15 };
+	static const int HEAD = 16; // 活动记录头部字节数
+
+	vector<uint8_t> buf;
+	vector<size_t> label;              // Pcode地址 -> 机器码偏移
+	vector<pair<size_t, int>> jumps;   // 待回填的rel32位置, 目标Pcode地址
+	size_t errorAt = 0, endAt = 0, returnAt = 0;
+	vector<size_t> callStub;           // 各过程的入口桩
+	size_t osrStub = 0;                // 循环头入口桩
+	int argCount = 1;
+	uint8_t* mem = nullptr;
+	size_t memSize = 0;
+
+	// ---------- 指令模板 ----------
+	bool emitIns(const Ins& ins, int self, const Pcode& pcode, const DebugInfo& dbg) {
+		int lv = dbg.procs[self].level;
+		switch (ins.f) {
+		case op::LIT:
+			movMI(RBX, 0, ins.A);
+			addRbx(4);
+			return true;
+		case op::LOD:
+			varBase(ins.L, lv);
+			movRM(RAX, varReg(ins.L, lv), HEAD + 4 * ins.A);
+			movMR(RBX, 0, RAX);
+			addRbx(4);
+			return true;
+		case op::STO:
+			movRM(RAX, RBX, -4);
+			addRbx(-4);
+			if (ins.L == -1) {
+				movRM64(RCX, R15, offsetof(JitContext, args));
+				movMR(RCX, 4 * ins.A, RAX);
+			}
+			else {
+				varBase(ins.L, lv);
+				movMR(varReg(ins.L, lv), HEAD + 4 * ins.A, RAX);
+			}
+			return true;
+		case op::CAL:
+		{
+			const ProcInfo* proc = pcode.entryProc[ins.A];
+			int idc = proc->id_count;
+			int need = 4 + idc + pcode.maxStack[proc - dbg.procs.data()];
+			// 空间检查
+			leaR64(RAX, RBX, 4 * need);
+			cmpRR64(RAX, R14);
+			int over = jccRel(0x87);//ja
+			// 头部：动态链接、被覆盖的display项
+			movMR64(RBX, 0, R12);
+			movRM64(RAX, R13, 8 * proc->level);
+			movMR64(RBX, 8, RAX);
+			movMR64(R13, 8 * proc->level, RBX);
+			movRR64(R12, RBX);
+			// 形参取自参数缓冲区（取后清零），其余变量清零
+			if (proc->param_count > 0) movRM64(RCX, R15, offsetof(JitContext, args));
+			for (int k = 0; k < idc; k++) {
+				if (k < proc->param_count && k < argCount) {
+					movRM(RAX, RCX, 4 * k);
+					movMR(R12, HEAD + 4 * k, RAX);
+					movMI(RCX, 4 * k, 0);
+				}
+				else {
+					movMI(R12, HEAD + 4 * k, 0);
+				}
+			}
+			leaR64(RBX, R12, HEAD + 4 * idc);
+			callTo(ins.A);
+			int skip = jmpRel();
+			// 栈溢出：报告后终止（与解释器相同）
+			patch(over, buf.size());
+			callC((void*)&jitOverflow);
+			patch(skip, buf.size());
+			return true;
+		}
+		case op::INT:
+			return true;
+		case op::JMP:
+			jmpTo(ins.A);
+			return true;
+		case op::JPC:
+			addRbx(-4);
+			movRM(RAX, RBX, 0);
+			testRR(RAX, RAX);
+			jccTo(0x84, ins.A);//jz
+			return true;
+		case op::RED:
+			// jitRead(sp)：成功时值已写入栈顶单元
+			movRR64(RDI, RBX);
+			callC((void*)&jitRead);
+			testRR(RAX, RAX);
+			jccAbs(0x84, errorAt);
+			addRbx(4);
+			return true;
+		case op::WRT:
+			addRbx(-4);
+			movRM(RDI, RBX, 0);
+			callC((void*)&jitWrite);
+			return true;
+		case op::RET:
+			if (self == 0) {//主程序结束
+				jmpAbs(endAt);
+				return true;
+			}
+			// 恢复display项和栈顶，回到调用者活动记录
+			movRM64(RAX, R12, 8);
+			movMR64(R13, 8 * lv, RAX);
+			movRR64(RBX, R12);
+			movRM64(R12, R12, 0);
+			emit(0xC3);
+			return true;
+		case op::NEG:
+			movRM(RAX, RBX, -4);
+			emit(0xF7); emit(0xD8);//neg eax
+			movMR(RBX, -4, RAX);
+			return true;
+		case op::ODD:
+			movRM(RAX, RBX, -4);
+			movRI(RCX, 2);
+			emit(0x99);//cdq
+			emit(0xF7); emit(0xF9);//idiv ecx
+			movMR(RBX, -4, RDX);
+			return true;
+		case op::DUP:
+			movRM(RAX, RBX, -4);
+			movMR(RBX, 0, RAX);
+			addRbx(4);
+			return true;
+		case op::ADD: case op::SUB: case op::MUL:
+			movRM(RAX, RBX, -8);
+			movRM(RCX, RBX, -4);
+			if (ins.f == op::ADD) { emit(0x01); emit(0xC8); }//add eax, ecx
+			else if (ins.f == op::SUB) { emit(0x29); emit(0xC8); }//sub eax, ecx
+			else { emit(0x0F); emit(0xAF); emit(0xC1); }//imul eax, ecx
+			movMR(RBX, -8, RAX);
+			addRbx(-4);
+			return true;
+		case op::DIV:
+		{
+			movRM(RCX, RBX, -4);
+			testRR(RCX, RCX);
+			int ok = jccRel(0x85);//jnz
+			callC((void*)&jitDivZero);
+			jmpAbs(errorAt);
+			patch(ok, buf.size());
+			movRM(RAX, RBX, -8);
+			// INT_MIN / -1 会使idiv触发异常，与解释器一样报告除法溢出
+			emit(0x83); emit(0xF9); emit(0xFF);//cmp ecx, -1
+			int fine = jccRel(0x85);//jne
+			emit(0x3D); emit32(INT_MIN);//cmp eax, INT_MIN
+			int fine2 = jccRel(0x85);//jne
+			callC((void*)&jitDivOverflow);
+			jmpAbs(errorAt);
+			patch(fine, buf.size());
+			patch(fine2, buf.size());
+			emit(0x99);//cdq
+			emit(0xF7); emit(0xF9);//idiv ecx
+			movMR(RBX, -8, RAX);
+			addRbx(-4);
+			return true;
+		}
+		case op::EQ: case op::NE: case op::LT: case op::LE: case op::GT: case op::GE:
+			movRM(RAX, RBX, -8);
+			movRM(RCX, RBX, -4);
+			emit(0x39); emit(0xC8);//cmp eax, ecx
+			emit(0x0F); emit(setcc(ins.f)); emit(0xC0);//setcc al
+			emit(0x0F); emit(0xB6); emit(0xC0);//movzx eax, al
+			movMR(RBX, -8, RAX);
+			addRbx(-4);
+			return true;
+		case op::JPCEQ: case op::JPCNE: case op::JPCLT: case op::JPCLE: case op::JPCGT: case op::JPCGE:
+			// 比较不成立时跳转
+			movRM(RAX, RBX, -8);
+			movRM(RCX, RBX, -4);
+			addRbx(-8);
+			emit(0x39); emit(0xC8);//cmp eax, ecx
+			jccTo(setcc(jumpCmp(ins.f)) ^ 0x01 ^ 0x10, ins.A);//setcc 0x9x 取反后为 jcc 0x8x
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// 保存被调用者保存寄存器，从上下文（rdi）装入常驻寄存器
+	void enter() {
+		push(RBX); push(RBP); push(R12); push(R13); push(R14); push(R15);
+		subRsp8();
+		movRR64(R15, RDI);
+		movMR64(R15, offsetof(JitContext, savedRsp), RSP);
+		movRM64(RBX, R15, offsetof(JitContext, sp));
+		movRM64(R12, R15, offsetof(JitContext, bp));
+		movRM64(R13, R15, offsetof(JitContext, display));
+		movRM64(R14, R15, offsetof(JitContext, limit));
+	}
+
+	// setcc 的第二个操作码字节
+	static uint8_t setcc(op f) {
+		switch (f) {
+		case op::EQ: return 0x94;
+		case op::NE: return 0x95;
+		case op::LT: return 0x9C;
+		case op::LE: return 0x9E;
+		case op::GT: return 0x9F;
+		default: return 0x9D;//GE
+		}
+	}
+
+	// 变量所在活动记录基址：本层用r12，外层从display表取到rdx
+	void varBase(int L, int lv) {
+		if (L != lv) movRM64(RDX, R13, 8 * L);
+	}
+	static Reg varReg(int L, int lv) {
+		return L == lv ? R12 : RDX;
+	}
+
+	// ---------- 编码 ----------
+	void emit(uint8_t b) { buf.push_back(b); }
+	void emit32(int32_t v) {
+		uint8_t b[4];
+		memcpy(b, &v, 4);
+		buf.insert(buf.end(), b, b + 4);
+	}
+	void rex(bool w, int reg, int base) {
+		uint8_t r = 0x40 | (w ? 8 : 0) | ((reg >> 3) << 2) | (base >> 3);
+		if (r != 0x40) emit(r);
+	}
+	// [base + disp32]
+	void mem32(int reg, int base, int32_t disp) {
+		emit(0x80 | ((reg & 7) << 3) | (base & 7));
+		if ((base & 7) == RSP) emit(0x24);//rsp、r12作基址需要SIB
+		emit32(disp);
+	}
+	void movRM(int r, int base, int32_t disp) { rex(false, r, base); emit(0x8B); mem32(r, base, disp); }
+	void movMR(int base, int32_t disp, int r) { rex(false, r, base); emit(0x89); mem32(r, base, disp); }
+	void movRM64(int r, int base, int32_t disp) { rex(true, r, base); emit(0x8B); mem32(r, base, disp); }
+	void movMR64(int base, int32_t disp, int r) { rex(true, r, base); emit(0x89); mem32(r, base, disp); }
+	void leaR64(int r, int base, int32_t disp) { rex(true, r, base); emit(0x8D); mem32(r, base, disp); }
+	void movMI(int base, int32_t disp, int32_t v) { rex(false, 0, base); emit(0xC7); mem32(0, base, disp); emit32(v); }
+	void movRI(int r, int32_t v) { rex(false, 0, r); emit(0xB8 + (r & 7)); emit32(v); }
+	void movRR64(int dst, int src) { rex(true, src, dst); emit(0x89); emit(0xC0 | ((src & 7) << 3) | (dst & 7)); }
+	void cmpRR64(int a, int b) { rex(true, b, a); emit(0x39); emit(0xC0 | ((b & 7) << 3) | (a & 7)); }
+	void testRR(int a, int b) { rex(false, b, a); emit(0x85); emit(0xC0 | ((b & 7) << 3) | (a & 7)); }
+	void addRbx(int32_t v) { emit(0x48); emit(0x81); emit(0xC3); emit32(v); }//add rbx, imm32
+	void subRsp8() { emit(0x48); emit(0x83); emit(0xEC); emit(0x08); }
+	void addRsp8() { emit(0x48); emit(0x83); emit(0xC4); emit(0x08); }
+	void push(int r) { if (r >= 8) emit(0x41); emit(0x50 + (r & 7)); }
+	void pop(int r) { if (r >= 8) emit(0x41); emit(0x58 + (r & 7)); }
+
+	// 调用C函数：按16字节对齐本机栈，rbp在调用期间保存原栈指针
+	void callC(void* fn) {
+		movRR64(RBP, RSP);
+		emit(0x48); emit(0x83); emit(0xE4); emit(0xF0);//and rsp, -16
+		emit(0x48); emit(0xB8);//mov rax, imm64
+		uint64_t a = (uint64_t)fn;
+		uint8_t b[8];
+		memcpy(b, &a, 8);
+		buf.insert(buf.end(), b, b + 8);
+		emit(0xFF); emit(0xD0);//call rax
+		movRR64(RSP, RBP);
+	}
+
+	// 跳转，返回rel32所在位置供回填
+	int jmpRel() { emit(0xE9); emit32(0); return buf.size() - 4; }
+	int jccRel(uint8_t cc) { emit(0x0F); emit(cc); emit32(0); return buf.size() - 4; }
+	void patch(size_t at, size_t target) {
+		int32_t rel = (int32_t)(target - (at + 4));
+		memcpy(&buf[at], &rel, 4);
+	}
+	void jmpTo(int pc) { jumps.push_back({ (size_t)jmpRel(), pc }); }
+	void jccTo(uint8_t cc, int pc) { jumps.push_back({ (size_t)jccRel(cc), pc }); }
+	void callTo(int pc) { emit(0xE8); emit32(0); jumps.push_back({ buf.size() - 4, pc }); }
+	void jmpAbs(size_t target) { patch(jmpRel(), target); }
+	void jccAbs(uint8_t cc, size_t target) { patch(jccRel(cc), target); }
+};
+
+/*
+分层执行的本机层
+首次升级时翻译全部代码（模板翻译只需一遍扫描），但只有升级的过程、循环经入口桩使用
+解释器的活动记录头部存下标，本机代码存指针：转入前按解释器的display建立指针display，
+OSR时临时把当前活动记录头部改为本机格式，返回后恢复，再由解释器完成返回
+*/
+class JitTier : public NativeTier {
+public:
+	JitTier(const Pcode& pcode, const DebugInfo& dbg) : pcode(pcode), dbg(dbg) {}
+
+	bool ready() override {
+		if (state == 0) {
+			auto start = chrono::steady_clock::now();
+			state = jit.compile(pcode, dbg) ? 1 : -1;
+			compileSec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			if (state < 0) cerr << "JIT 翻译失败（" << jit.error << "），分层执行只用解释器" << endl;
+			args.assign(jit.argSlots(), 0);
+		}
+		return state > 0;
+	}
+
+	int call(int proc, Activation& Ac, const vector<pair<int, int>>& actual) override {
+		load(Ac);
+		for (auto& a : actual) args[a.first - 4] = a.second;
+		return jit.callProc(proc, &ctx);
+	}
+
+	int enter(int pc, Activation& Ac) override {
+		load(Ac);
+		int* head = &Ac.stack[Ac.base];
+		int saved[4];
+		memcpy(saved, head, sizeof(saved));
+		int* link[2] = { Ac.stack.data() + saved[0], Ac.stack.data() + saved[2] };//动态链接、被覆盖的display项
+		memcpy(head, link, sizeof(link));
+		int r = jit.enterAt(pc, &ctx);
+		if (r == 2) memcpy(head, saved, sizeof(saved));
+		return r;
+	}
+
+	string describe() const override {
+		return "机器码 " + to_string(jit.codeBytes) + " 字节，翻译用时 " + to_string(compileSec * 1000) + " 毫秒";
+	}
+
+private:
+	const Pcode& pcode;
+	const DebugInfo& dbg;
+	Jit jit;
+	int state = 0; // 0 未翻译，1 可用，-1 翻译失败
+	double compileSec = 0;
+	JitContext ctx;
+	vector<int*> display;
+	vector<int> args;
+
+	void load(Activation& Ac) {
+		int* s = Ac.stack.data();
+		display.resize(Ac.display.size());
+		for (size_t l = 0; l < display.size(); l++) display[l] = s + Ac.display[l];
+		ctx.sp = s + Ac.top;
+		ctx.bp = s + Ac.base;
+		ctx.limit = s + Ac.stack.size();
+		ctx.display = display.data();
+		ctx.args = args.data();
+	}
+};
+
+#endif
+
+// 编译为机器码后执行；不支持的平台、开启跟踪或翻译失败时改用解释器
+void interpretJIT(Pcode& pcode, const DebugInfo& dbg) {
+#ifdef PL0_JIT
+	if (!trace_mode) {
+		Jit jit;
+		if (jit.compile(pcode, dbg)) {
+			if (!output.open(out_file) || !input.open(in_file)) return;
+			jit.run(dbg);
+			output.close();
+			input.close();
+			return;
+		}
+		cerr << "JIT 翻译失败（" << jit.error << "），改用解释器" << endl;
+	}
+	else {
+		cerr << "JIT 不支持跟踪，改用解释器" << endl;
+	}
+#else
+	cerr << "本平台不支持 JIT，改用解释器" << endl;
+#endif
+	pcode.interpret(dbg);
+}
+
+// 读取pcode文件及调试信息（或二进制映像）后执行
+void interpretJIT(Pcode& pcode, const string& file) {
+	DebugInfo dbg;
+	if (!pcode.loadProgram(file, dbg)) return;
+	interpretJIT(pcode, dbg);
+}
+
+// 分层执行：先解释执行，调用或循环次数超过阈值的过程改用机器码；不支持的平台或开启跟踪时只用解释器
+void interpretTiered(Pcode& pcode, const DebugInfo& dbg) {
+#ifdef PL0_JIT
+	if (!trace_mode) {
+		JitTier tier(pcode, dbg);
+		pcode.tier = &tier;
+		pcode.interpret(dbg);
+		pcode.tier = nullptr;
+		return;
+	}
+	cerr << "分层执行不支持跟踪，只用解释器" << endl;
+#else
+	cerr << "本平台不支持 JIT，分层执行只用解释器" << endl;
+#endif
+	pcode.interpret(dbg);
+}
+
+void interpretTiered(Pcode& pcode, const string& file) {
+	DebugInfo dbg;
+	if (!pcode.loadProgram(file, dbg)) return;
+	interpretTiered(pcode, dbg);
+}
@@ -0,0 +1,330 @@
+/*
+Pcode 优化
+死代码消除：删除从主程序不可达的过程和分支、跳转到下一条的JMP，并重排地址
+窥孔优化：在Pcode::code上按规则做局部改写直到不动点，不改写跳转目标处的指令
+超级指令：把常见的指令序列融合为一次分派，可按 seqmine.py 统计的剖析文件只启用最常执行的前N种
+*/
+
+#pragma once
+#include<iostream>
+#include<vector>
+#include<string>
+#include<fstream>
+#include<sstream>
+#include<algorithm>
+#include"SymbolTable.h"
+#include"Pcode.h"
+#include"config.h"
+
+using namespace std;
+
+// 窥孔规则
+enum PeepRule {
+	PEEP_STO_LOD,    // STO x; LOD x  -> DUP(复制栈顶); STO x
+	PEEP_JMP_CHAIN,  // 跳转到JMP的JMP/JPC直接跳到最终目标
+	PEEP_JMP_NEXT,   // 跳转到下一条的JMP删除
+	PEEP_IDENTITY,   // LIT 0; OPR +/-  或 LIT 1; OPR */除  删除
+	PEEP_NEG_LIT,    // LIT n; OPR 0 1 -> LIT -n
+	PEEP_FOLD,       // LIT a; LIT b; OPR op -> LIT (a op b)
+	PEEP_CMP_JPC,    // 比较; JPC 0 A -> JPC系列比较后条件跳转
+	PEEP_RULE_COUNT
+};
+
+const char* peepRuleName(int rule) {
+	switch (rule) {
+	case PEEP_STO_LOD: return "sto-lod";
+	case PEEP_JMP_CHAIN: return "jmp-chain";
+	case PEEP_JMP_NEXT: return "jmp-next";
+	case PEEP_IDENTITY: return "identity";
+	case PEEP_NEG_LIT: return "neg-lit";
+	case PEEP_FOLD: return "fold";
+	case PEEP_CMP_JPC: return "cmp-jpc";
+	default: return "";
+	}
+}
+
+class Optimizer {
+public:
+	int deadProcs = 0;   // 删除的不可达过程个数
+	int deadIns = 0;     // 删除的不可达指令条数
+	int nextJumps = 0;   // 删除的跳转到下一条的JMP条数
+
+	int peepHits[PEEP_RULE_COUNT] = { 0 }; // 各窥孔规则命中次数
+	int peepRounds = 0;                    // 窥孔优化迭代轮数
+	int peepRemoved = 0;                   // 窥孔优化删除的指令条数
+
+	vector<op> superOn;                    // 启用的超级指令，按优先级排列
+	int superHits[(int)op::COUNT] = { 0 }; // 各超级指令融合次数
+
+	// 规则开关，peephole_off 中列出的规则名被关闭
+	bool ruleOn(int rule) {
+		return peephole_off.find(peepRuleName(rule)) == peephole_off.end();
+	}
+
+	// 剖析文件中的统计键 -> 指令（只有操作码有意义）
+	static bool insFromKey(const string& key, Ins& ins) {
+		size_t colon = key.find(':');
+		if (colon == string::npos) return insFromText(key, 0, 0, ins);
+		string name = key.substr(0, colon);
+		int code = atoi(key.c_str() + colon + 1);
+		if (name == "OPR") return insFromText(name, 0, code, ins);
+		return insFromText(name, code, 0, ins);
+	}
+
+	// 从地址0出发沿控制流求可达指令（过程只能经CAL进入）
+	static vector<bool> reachable(const vector<Ins>& code) {
+		int n = code.size();
+		vector<bool> reach(n, false);
+		vector<int> work;
+		if (n > 0) {
+			reach[0] = true;
+			work.push_back(0);
+		}
+		auto visit = [&](int t) {
+			if (t >= 0 && t < n && !reach[t]) {
+				reach[t] = true;
+				work.push_back(t);
+			}
+			};
+		while (!work.empty()) {
+			int i = work.back();
+			work.pop_back();
+			const Ins& ins = code[i];
+			if (ins.f == op::JMP) {
+				visit(ins.A);
+			}
+			else if (hasTarget(ins.f)) {//JPC系列、CAL
+				visit(ins.A);
+				visit(i + 1);
+			}
+			else if (ins.f == op::RET) {
+				//过程返回，无后继
+			}
+			else {
+				visit(i + 1);
+			}
+		}
+		return reach;
+	}
+
+	// 死代码消除，重复进行直到没有可删除的指令（删除分支后可能产生新的跳转到下一条）
+	void eliminateDeadCode(Pcode& pcode, SymbolTable& symTable) {
+		while (true) {
+			vector<Ins>& code = pcode.code;
+			int n = code.size();
+			vector<bool> reach = reachable(code);
+			vector<bool> keep(n, true);
+			bool changed = false;
+			for (int i = 0; i < n; i++) {
+				if (!reach[i]) {
+					keep[i] = false;
+					deadIns++;
+					changed = true;
+				}
+				else if (code[i].f == op::JMP && code[i].A == i + 1) {
+					keep[i] = false;
+					nextJumps++;
+					changed = true;
+				}
+			}
+			if (!changed) break;
+
+			vector<int> newAddr = pcode.compact(keep);
+			for (int i = 0; i < n; i++) {
+				if (!reach[i]) newAddr[i] = -1;
+			}
+			deadProcs += symTable.relocateProcEntries(newAddr);
+		}
+	}
+
+	// 窥孔优化，重复扫描直到没有规则命中
+	void peephole(Pcode& pcode, SymbolTable& symTable) {
+		while (true) {
+			vector<Ins>& code = pcode.code;
+			int n = code.size();
+			//跳转目标（含过程入口）处的指令不能被删除或与前一条合并
+			vector<bool> target(n + 1, false);
+			target[0] = true;
+			for (const Ins& ins : code) {
+				if (hasTarget(ins.f) && ins.A >= 0 && ins.A <= n) {
+					target[ins.A] = true;
+				}
+			}
+
+			vector<bool> keep(n, true);
+			bool changed = false;
+			auto hit = [&](int rule) {
+				peepHits[rule]++;
+				changed = true;
+				};
+
+			for (int i = 0; i < n; i++) {
+				Ins& a = code[i];
+				bool hasB = i + 1 < n && !target[i + 1];
+				Ins* b = hasB ? &code[i + 1] : nullptr;
+
+				if (hasTarget(a.f) && a.f != op::CAL && ruleOn(PEEP_JMP_CHAIN)) {
+					int t = a.A, steps = 0;
+					while (t >= 0 && t < n && code[t].f == op::JMP && code[t].A != t && steps < n) {
+						t = code[t].A;
+						steps++;
+					}
+					if (t != a.A) {
+						a.A = t;
+						hit(PEEP_JMP_CHAIN);
+					}
+				}
+				if (a.f == op::JMP && a.A == i + 1 && ruleOn(PEEP_JMP_NEXT)) {
+					keep[i] = false;
+					hit(PEEP_JMP_NEXT);
+					continue;
+				}
+				if (b == nullptr) continue;
+
+				if (a.f == op::STO && b->f == op::LOD && a.L != -1 && a.L == b->L && a.A == b->A && ruleOn(PEEP_STO_LOD)) {
+					Ins sto = a;
+					a.f = op::DUP;
+					a.L = 0;
+					a.A = 0;
+					*b = sto;
+					hit(PEEP_STO_LOD);
+					i++;
+				}
+				else if (a.f == op::LIT && ruleOn(PEEP_IDENTITY) && !target[i]
+					&& ((a.A == 0 && (b->f == op::ADD || b->f == op::SUB)) || (a.A == 1 && (b->f == op::MUL || b->f == op::DIV)))) {
+					keep[i] = keep[i + 1] = false;
+					hit(PEEP_IDENTITY);
+					i++;
+				}
+				else if (a.f == op::LIT && b->f == op::NEG && ruleOn(PEEP_NEG_LIT)) {
+					a.A = (int)(0u - (unsigned)a.A);//与运行时一致，INT_MIN取负仍为INT_MIN
+					keep[i + 1] = false;
+					hit(PEEP_NEG_LIT);
+					i++;
+				}
+				else if (isCmp(a.f) && b->f == op::JPC && ruleOn(PEEP_CMP_JPC)) {
+					b->f = cmpJump(a.f);
+					keep[i] = false;
+					hit(PEEP_CMP_JPC);
+					i++;
+				}
+				else if (a.f == op::LIT && b->f == op::LIT && i + 2 < n && !target[i + 2] && ruleOn(PEEP_FOLD)) {
+					int result = 0;
+					if (evalOpr(code[i + 2].f, a.A, b->A, result)) {
+						a.A = result;
+						keep[i + 1] = keep[i + 2] = false;
+						hit(PEEP_FOLD);
+						i += 2;
+					}
+				}
+			}
+			if (!changed) break;
+			peepRounds++;
+
+			int removed = 0;
+			for (bool k : keep) if (!k) removed++;
+			if (removed > 0) {
+				peepRemoved += removed;
+				symTable.relocateProcEntries(pcode.compact(keep));
+			}
+		}
+	}
+
+	/*
+	选择启用的超级指令
+	没有剖析文件时全部启用；否则按剖析文件中各超级指令序列的执行次数乘以省去的分派次数排序，取前top种（0为不限）
+	剖析文件每行：次数 统计键...，统计键为 LOD、LIT、STO、OPR:子操作、JPC:比较码 等
+	*/
+	void selectSuperinstructions(const string& profile, int top) {
+		superOn.clear();
+		vector<pair<long long, op>> score;
+		for (int s = (int)op::LLOS; s <= (int)op::LSTO; s++) {
+			score.push_back({ 0, (op)s });
+		}
+
+		if (!profile.empty()) {
+			ifstream ifs(profile);
+			if (!ifs.is_open()) {
+				cerr << "无法打开剖析文件: " << profile << endl;
+				exit(1);
+			}
+			string line;
+			while (getline(ifs, line)) {
+				istringstream in(line);
+				long long cnt = 0;
+				string key;
+				vector<Ins> seq;
+				if (!(in >> cnt)) continue;
+				bool ok = true;
+				while (in >> key) {
+					Ins ins;
+					ok = ok && insFromKey(key, ins);
+					seq.push_back(ins);
+				}
+				if (!ok || seq.size() < 2) continue;
+				for (auto& sc : score) {
+					if ((int)seq.size() == superLen(sc.second) && seq[0].f == superHead(sc.second) && superTail(sc.second, &seq[1])) {
+						sc.first += cnt * (superLen(sc.second) - 1);
+					}
+				}
+			}
+			stable_sort(score.begin(), score.end(), [](const pair<long long, op>& a, const pair<long long, op>& b) {
+				return a.first > b.first;
+				});
+		}
+		for (auto& sc : score) {
+			if (!profile.empty() && sc.first == 0) break;
+			if (top > 0 && (int)superOn.size() >= top) break;
+			superOn.push_back(sc.second);
+		}
+		//融合时长的序列优先，省去的分派更多
+		stable_sort(superOn.begin(), superOn.end(), [](op a, op b) {
+			return superLen(a) > superLen(b);
+			});
+	}
+
+	// 融合超级指令，只改写序列首条指令的操作码，地址不变；序列内部不能有跳转目标
+	void superinstructions(Pcode& pcode) {
+		vector<Ins>& code = pcode.code;
+		int n = code.size();
+		vector<bool> target(n + 1, false);
+		for (const Ins& ins : code) {
+			if (hasTarget(ins.f) && ins.A >= 0 && ins.A <= n) {
+				target[ins.A] = true;
+			}
+		}
+		for (int i = 0; i < n; i++) {
+			for (op s : superOn) {
+				int len = superLen(s);
+				if (i + len > n || code[i].f != superHead(s) || !superTail(s, &code[i + 1])) continue;
+				bool inner = false;
+				for (int k = 1; k < len; k++) inner = inner || target[i + k];
+				if (inner) continue;
+				code[i].f = s;
+				superHits[(int)s]++;
+				i += len - 1;
+				break;
+			}
+		}
+	}
+
+	void printReport() {
+		cout << "死代码消除：删除不可达过程 " << deadProcs << " 个，不可达指令 " << deadIns
+			<< " 条，跳转到下一条的JMP " << nextJumps << " 条" << endl;
+	}
+
+	void printSuperReport() {
+		cout << "超级指令：";
+		for (op s : superOn) {
+			cout << opName(s) << " " << superHits[(int)s] << "  ";
+		}
+		cout << endl;
+	}
+
+	void printPeepholeReport() {
+		cout << "窥孔优化：" << peepRounds << " 轮，删除指令 " << peepRemoved << " 条" << endl;
+		for (int r = 0; r < PEEP_RULE_COUNT; r++) {
+			cout << "  " << peepRuleName(r) << (ruleOn(r) ? "" : "(关闭)") << ": " << peepHits[r] << endl;
+		}
+	}
+};
@@ -1,7 +1,7 @@
 /*
-LL(1) ﷨ͷļ
-
-P
+LL(1) 语法分析器头文件
+语义分析
+P代码生成
 */
 
 #pragma once
@@ -15,38 +15,42 @@ P
 #include"config.h"
 #include"SymbolTable.h"
 #include"Pcode.h"
+#include"Semantic.h"
+#include"Optimizer.h"
 #include "tokenization.h"
 
 using namespace std;
 
-int line_num = 0;//ڴк
+int line_num = 0;//正在处理的行号
 
-SymbolTable symTable; // ȫַűʵ
-Pcode pcode;      // ȫPʵ
+SymbolTable symTable; // 全局符号表实例
+Pcode pcode;      // 全局P代码实例
+SemanticChecker semChecker; // 语义检查遍，收集过程体内的标识符引用
 
-vector<string> symName;//ŵǰķ
-vector<string> symValue ;//ŵǰķֵ
-vector<int> pc;//ŵǰPcodeַ
+vector<string> symName;//辅助变量，存放当前处理的符号名称
+vector<SrcPos> symPos;//辅助变量，与symName对应的源码位置
+vector<string> symValue ;//辅助变量，存放当前处理的符号值
+vector<int> pc;//辅助变量，存放当前处理的Pcode地址
 
 vector <int> tmplop;
 vector<string> sign;
 vector<string> aop;
 vector<string> mop;
-int arg_count = 0;//callò
-vector<int> begin_while;//while俪ʼַջ
+int arg_count = 0;//call调用参数个数
+vector<int> begin_while;//while语句开始地址栈
 
 
 class Parser
 {
 private:
-	fstream srcFile;//мļŴʷ
-	vector<string> symbols;//ջս
+	fstream srcFile;//中间文件，存放词法分析结果
+	vector<string> symbols;//符号栈，非终结符
 	Token currentToken;
-	tokenizationer tokener;//ʷ
+	tokenizationer tokener;//词法分析器
 	vector<Token> tokens;
 
 
-	string state = "";//ǰ״̬
+	string state = "";//当前状态
 	unordered_set<string> panicstates = { "assignment","if","while","call","read","write"};
 	unordered_map<string, vector<string>> panicstatemap = {
 		{"assignment",{"ID",":=", "< exp >" ,"_assignment"}},
@@ -60,54 +64,74 @@ private:
 
 	bool back_token = false;
 
-	// ӡսϸ
+	// 打印终结符详细错误
 	void syntaxErrorDetail(const string& expected, const string& hint = "") {
-		cerr << "﷨: (" << currentToken.row << "," << currentToken.column << ") "
-			<< expected << " '" << currentToken.value << "'(" << tokenTypeName(currentToken.type) << ")";
-		if (!hint.empty()) cerr << ": " << hint<<endl;
+		cerr << "语法错误: 在(" << currentToken.row << "," << currentToken.column << ")处，期望 "
+			<< expected << "，但遇到 '" << currentToken.value << "'(" << tokenTypeName(currentToken.type) << ")";
+		if (!hint.empty()) cerr << "。建议: " << hint<<endl;
 		exit(1);
 	}
 
-	// սƥ䣬 match 
+	// 终结符匹配，供 match 调用
 	bool expectTerminal(const string& name, TokenType t, const string& hint = "") {
 		if (currentToken.type == t) {
 			symbols.erase(symbols.begin());
+			//记录源码位置，供错误信息和pcode行号映射使用
+			line_num = currentToken.row;
+			pcode.setPos(currentToken.row, currentToken.column);
 
 			currentToken = getNextToken();
 			return true;
 		}
-		// Իָʾһͬ
+		// 报错并尝试恢复：先提示，再跳到下一个同步点继续解析
 		//syntaxErrorDetail(name, hint);
 		return false;
 	}
 
 
-	//  class Parser  private 
-	void reportSemanticError(const string& msg, const Token& tok) {
-		cerr << ": (" << tok.row << "," << tok.column << "): " << msg << endl;
-		exit(1);
-	}
-
-	Symbol* lookupSymbolOrReport(const string& name, const Token& tok) {
-		try {
-			int level_diff = 0;
-			return symTable.findGlobal(name, level_diff);
+	// 输出语义检查遍的全部诊断，有错误则终止
+	void reportSemanticErrors(const vector<Diagnostic>& diags) {
+		for (const Diagnostic& d : diags) {
+			cerr << "语义错误: 在(" << d.row << "," << d.column << ")处: " << d.msg << endl;
 		}
-		catch (const SymbolError& e) {
-			reportSemanticError(e.what(), tok);
-			return nullptr; // ᵽУ
+		if (!diags.empty()) {
+			cerr << "共 " << diags.size() << " 个语义错误" << endl;
+			exit(1);
 		}
 	}
 
+	// 查找符号用于生成代码，并记录引用交给语义检查遍；未定义返回nullptr，不在此处报错
+	// 与语义检查遍相同，从当前层按静态作用域向外查找，内层同名符号遮蔽外层
+	Symbol* lookupSymbolOrRecord(const string& name, const SrcPos& at, RefKind kind, int& level_diff, int args = 0) {
+		int level = 0;
+		Symbol* sym = symTable.findVisible(symTable.current_layer_, name, level);
+		if (sym != nullptr) level_diff = -level;//层差 = 调用层(0) - 定义层，与原查找方式一致
+		SymRef ref;
+		ref.name = name;
+		ref.kind = kind;
+		ref.arg_count = args;
+		ref.row = at.row;
+		ref.column = at.column;
+		ref.resolved = sym != nullptr;
+		semChecker.addRef(symTable.current_layer_, ref);
+		return sym;
+	}
+
+	// 符号无法用于生成代码时生成占位指令，并记录错误（语义检查遍已报告同一位置时不重复）
+	void emitPlaceholder(op f, const string& name, const SrcPos& at, const string& msg) {
+		pcode.emit(f, 0, 0);
+		semChecker.addError(at.row, at.column, name + msg);
+	}
+
 
 public:
 	Parser(const string& srcPath):tokener("pascal.txt", "out.txt") {
 		srcFile.open(srcPath);
 		if (!srcFile.is_open()) {
-			cerr << "Դļ" << srcPath << "ʧ" << endl;
+			cerr << "源文件" << srcPath << "打开失败" << endl;
 			exit(1);
 		}
-		symbols.push_back(string("<prog>")); //ʼ
+		symbols.push_back(string("<prog>")); //开始符号
 	}
 	~Parser() {
 		if (srcFile.is_open()) {
@@ -115,13 +139,13 @@ public:
 		}
 	}
 
-	Token getNextToken() {// ȡһ Token ߼
+	Token getNextToken() {// 获取下一个 Token 的逻辑
 		if (back_token) {
 			back_token = false;
 			return Token();
 		}
 
-		//ʽ
+		//缓冲区方式
 
 		if (tokens.empty()) {
 			tokener.getTokens(20, tokens);
@@ -131,36 +155,36 @@ public:
 		return t;
 
 
-		//һʽʽ
+		//一遍式方式
 
 		//std::string line;
-		//// ȡһУ򷵻 EOF token
+		//// 读取一行，若读不到则返回 EOF token
 		//if (!std::getline(srcFile, line)) {
 		//	return Token{ TokenType::EOF_TOKEN, "EOF", 0, 0 };
 		//}
 		//
-		//// 
+		//// 跳过空行
 		//while (line.empty() && std::getline(srcFile, line)) {}
 		//if (line.empty()) {
 		//	return Token{ TokenType::EOF_TOKEN, "EOF", 0, 0 };
 		//}
 		//
-		//// ʽ: TYPE(value)(row,column)
+		//// 期望格式: TYPE(value)(row,column)
 		//auto p1 = line.find('(');
 		//if (p1 == std::string::npos) {
-		//	cerr << "Ч token : " << line << endl;
+		//	cerr << "无效的 token 行: " << line << endl;
 		//	return Token{ TokenType::ERROR, line, 0, 0 };
 		//}
 		//std::string typeStr = line.substr(0, p1);
 		//
 		//auto p2 = line.find(')', p1 + 1);
 		//if (p2 == std::string::npos) {
-		//	cerr << "Ч token (ȱ )): " << line << endl;
+		//	cerr << "无效的 token 行(缺少 )): " << line << endl;
 		//	return Token{ TokenType::ERROR, line, 0, 0 };
 		//}
 		//std::string valueStr = line.substr(p1 + 1, p2 - p1 - 1);
 		//
-		//// жԣ p2 ֮Ѱһ '(' ͶӦ ')'
+		//// 查找行列对：在 p2 之后寻找下一个 '(' 和对应的 ')'
 		//auto p3 = line.find('(', p2 + 1);
 		//auto p4 = (p3 == std::string::npos) ? std::string::npos : line.find(')', p3 + 1);
 		//int row = 0, column = 0;
@@ -184,7 +208,7 @@ public:
 		//	token.type = it->second;
 		//}
 		//else {
-		//	cerr << "δ֪Token: " << typeStr << " : " << line << endl;
+		//	cerr << "未知Token类型: " << typeStr << " 行: " << line << endl;
 		//	token.type = TokenType::ERROR;
 		//}
 		//
@@ -196,13 +220,13 @@ public:
 
 	void skipToNextStatement() {
 
-		// ֱһֺŻ END ؼ
+		// 跳过直到下一个分号或 END 关键字
 		while (currentToken.type != TokenType::SEMICOLON &&
 			currentToken.type != TokenType::END &&
 			currentToken.type != TokenType::EOF_TOKEN) {
 			currentToken = getNextToken();
 		}
-		// ֺţٶȡһ token 
+		// 如果遇到分号，则再读取下一个 token 继续
 		if (currentToken.type == TokenType::SEMICOLON) {
 			currentToken = getNextToken();
 		}
@@ -210,236 +234,242 @@ public:
 
 	bool match(string symbol) {
 		/*
-		  - [] ѡɷ֣ɳ0λ1Σ
-		 - {} ظɷ֣ɳ0λΣ
-		  - |  ѡϵѡѡһ
-		  - "" սؼ֡šȣ
-		  - <> ս﷨Ԫ
+		  - [] ：可选成分（可出现0次或1次）
+		 - {} ：重复成分（可出现0次或多次）
+		  - |  ：选择关系（多个选项中选一个）
+		  - "" ：终结符（关键字、符号、字面量等）
+		  - <> ：非终结符（语法单元）
 		 */
 		if (symbol == "INTEGER") {
-			symValue.push_back(currentToken.value);//ֵ
-			bool flag = expectTerminal("", TokenType::INTEGER, "Ҫ");
+			symValue.push_back(currentToken.value);//缓存整数值
+			bool flag = expectTerminal("整数常量", TokenType::INTEGER, "需要整数常量");
 			
 			return flag;
 		}
 		if (symbol == "ID") {
 			symName.push_back(currentToken.value);
-			bool flag = expectTerminal("ʶ", TokenType::IDENTIFIER, "Ҫʶ");
+			symPos.push_back({ currentToken.row, currentToken.column });
+			bool flag = expectTerminal("标识符", TokenType::IDENTIFIER, "需要标识符");
 			
 			return flag;
 		}
 		if (symbol == "END") {
-			return expectTerminal("ENDؼ", TokenType::END, "ҪENDؼ֣/ǣ");
+			return expectTerminal("END关键字", TokenType::END, "需要END关键字（程序/块结束标记）");
 		}
 		if (symbol == "THEN") {
-			return expectTerminal("THENؼ", TokenType::THEN, "IFҪTHENؼ");
+			return expectTerminal("THEN关键字", TokenType::THEN, "IF语句后需要THEN关键字");
 		}
 		if (symbol == "DO") {
-			return expectTerminal("DOؼ", TokenType::DO, "WHILEҪDOؼ");
+			return expectTerminal("DO关键字", TokenType::DO, "WHILE语句后需要DO关键字");
 		}
 		if (symbol == "LOP") {
-			// LOP  "=" | "<>" | "<" | "<=" | ">" | ">="
+			// LOP → "=" | "<>" | "<" | "<=" | ">" | ">="
 			tmplop.push_back(currentToken.value == "=" ? 7 :
 				currentToken.value == "<>" ? 8 :
 				currentToken.value == "<" ? 9 :
 				currentToken.value == "<=" ? 10 :
 				currentToken.value == ">" ? 11 :
 				currentToken.value == ">=" ? 12: -100);
-			return expectTerminal("ϵ", TokenType::LOP, "Ҫϵ=<><<=>>=");
+			return expectTerminal("关系运算符", TokenType::LOP, "需要关系运算符（=、<>、<、<=、>、>=）");
 		}
 		if (symbol == "MOP") {
-			// MOP  "*" | "/"
+			// MOP → "*" | "/"
 			mop.push_back(currentToken.value);
-			return expectTerminal("˷/", TokenType::MOP, "Ҫ˷*/");
+			return expectTerminal("乘法/除法运算符", TokenType::MOP, "需要乘法或除法运算符（*、/）");
 		}
 		if (symbol == "AOP") {
-			// AOP  "+" | "-"
+			// AOP → "+" | "-"
 			aop.push_back(currentToken.value);
-			return expectTerminal("ӷ/", TokenType::AOP, "Ҫӷ+-");
+			return expectTerminal("加法/减法运算符", TokenType::AOP, "需要加法或减法运算符（+、-）");
 		}
 		if (symbol == "WRITE") {
-			return expectTerminal("WRITEؼ", TokenType::WRITE, "ҪWRITEؼ֣ǣ");
+			return expectTerminal("WRITE关键字", TokenType::WRITE, "需要WRITE关键字（输出语句标记）");
 		}
 		if (symbol == "READ") {
-			return expectTerminal("READؼ", TokenType::READ, "ҪREADؼ֣ǣ");
+			return expectTerminal("READ关键字", TokenType::READ, "需要READ关键字（输入语句标记）");
 		}
 		if (symbol == "CALL") {
-			return expectTerminal("CALLؼ", TokenType::CALL, "ҪCALLؼ̵֣ñǣ");
+			return expectTerminal("CALL关键字", TokenType::CALL, "需要CALL关键字（过程调用标记）");
 		}
 		if (symbol == "IF") {
-			return expectTerminal("IFؼ", TokenType::IF, "ҪIFؼ֣ǣ");
+			return expectTerminal("IF关键字", TokenType::IF, "需要IF关键字（条件语句标记）");
 		}
 		if (symbol == "WHILE") {
-			return expectTerminal("WHILEؼ", TokenType::WHILE, "ҪWHILEؼ֣ѭǣ");
+			return expectTerminal("WHILE关键字", TokenType::WHILE, "需要WHILE关键字（循环语句标记）");
 		}
 		if (symbol == "ELSE") {
-			return expectTerminal("ELSEؼ", TokenType::ELSE, "IF-THENҪELSEؼ֣ѡ֧");
+			return expectTerminal("ELSE关键字", TokenType::ELSE, "IF-THEN语句后需要ELSE关键字（可选分支）");
 		}
 		if (symbol == "ODD") {
-			return expectTerminal("ODDؼ", TokenType::ODD, "ҪODDؼ֣żж");
+			return expectTerminal("ODD关键字", TokenType::ODD, "需要ODD关键字（奇偶判断运算符）");
 		}
 		if (symbol == "VAR") {
-			return expectTerminal("VARؼ", TokenType::VAR, "ҪVARؼ֣ǣ");
+			return expectTerminal("VAR关键字", TokenType::VAR, "需要VAR关键字（变量声明标记）");
 			
 		}
 		if (symbol == "CONST") {
-			return expectTerminal("CONSTؼ", TokenType::CONST, "ҪCONSTؼ֣ǣ");
+			return expectTerminal("CONST关键字", TokenType::CONST, "需要CONST关键字（常量声明标记）");
 		}
 		if (symbol == "SEMICOLON") {
-			return expectTerminal("ֺ ';'", TokenType::SEMICOLON, "Ҫֺ ';'");
+			return expectTerminal("分号 ';'", TokenType::SEMICOLON, "语句结束需要分号 ';'");
 		}
 		if (symbol == "PROCEDURE") {
-			return expectTerminal("PROCEDUREؼ", TokenType::PROCEDURE, "ҪPROCEDUREؼ֣ǣ");
+			return expectTerminal("PROCEDURE关键字", TokenType::PROCEDURE, "需要PROCEDURE关键字（过程声明标记）");
 		}
 		if (symbol == "BEGIN") {
-			return expectTerminal("BEGINؼ", TokenType::BEGIN, "ҪBEGINؼ֣/鿪ʼǣ");
+			return expectTerminal("BEGIN关键字", TokenType::BEGIN, "需要BEGIN关键字（程序/块开始标记）");
 		}
 		if (symbol == "COMMA") {
-			return expectTerminal(" ','", TokenType::COMMA, "ȱٶţָʶ/");
+			return expectTerminal("逗号 ','", TokenType::COMMA, "可能缺少逗号（分隔多个标识符/常量）");
 		}
 		if (symbol == "LPAREN") {
-			return expectTerminal(" '('", TokenType::LPAREN, "ȱ '('ʽ/бʼ");
+			return expectTerminal("左括号 '('", TokenType::LPAREN, "可能缺少左括号 '('（表达式/参数列表开始）");
 		}
 		if (symbol == "RPAREN") {
-			return expectTerminal(" ')'", TokenType::RPAREN, "ȱ ')'ʽ/б");
+			return expectTerminal("右括号 ')'", TokenType::RPAREN, "可能缺少右括号 ')'（表达式/参数列表结束）");
 		}
 		if (symbol == "COLONEQUAL") {
-			return expectTerminal("ֵ ':='", TokenType::COLONEQUAL, "ֵҪֵ ':='");
+			return expectTerminal("赋值运算符 ':='", TokenType::COLONEQUAL, "赋值语句需要赋值运算符 ':='");
 		}
 
 
-		//붯.....................................................
+		//翻译动作.....................................................
 		if(symbol == "_prog") {
-			/* P룺ɳָ 
+			/* P代码：生成程序入口指令 
 			Code[PC++] = { JMP, 0, 0 };*/
-			pcode.addJump();//תָ
-			pcode.emit("JMP", 0, 0);//ڵַ
+			pcode.addJump();//生成跳转指令
+			pcode.emit(op::JMP, 0, 0);//入口地址待回填
 
-			/*д*/
+			/*填写过程名字*/
 			symTable.current_layer_->setLayerName(symName.back());
 			symName.pop_back();
+			symPos.pop_back();
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_end_prog") {
-			/* P룺ɳָ 
+			/* P代码：生成程序结束指令 
 			Code[PC++] = { OPR, 0, 0 };*/
-			pcode.emit("OPR", 0, 0);
-			//
+			pcode.emit(op::RET, 0, 0);
+			//调试
 			/*symTable.printTable();
 			pcode.printCode();*/
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
-		if (symbol == "_const") {//һζһ
-			/* 1. ű{볣} */
+		if (symbol == "_const") {//一次定义一个常量
+			/* 1. 符号表：{插入常量} */
 			symTable.insertConst(symName.back(), stoi(symValue.back()));
 			symName.pop_back();
+			symPos.pop_back();
 			symValue.pop_back();
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
-		if (symbol == "_var") {//һζ
-			/* 1. ű{} */
+		if (symbol == "_var") {//一次定义多个变量
+			/* 1. 符号表：{插入变量} */
 			for (const auto& name : symName) {
 				symTable.insertVar(name);
 			}
 			symName.clear();
+			symPos.clear();
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_proc") {
-			/* 1. ű{̣,} */
+			/* 1. 符号表：{插入过程，进入过程,插入参数} */
 
 			int param_count = 0;
 			if (!symName.empty()) {
-				// symName[0] ΪʣԪΪ
+				// symName[0] 为过程名，剩余元素为参数名
 				param_count = static_cast<int>(symName.size()) - 1;
 			}
-			string procName = symName[0];//
+			string procName = symName[0];//过程名
 
-			Symbol* proc = symTable.insertProc(procName, param_count,pcode.PC);//
-			SymLayer* layer =  symTable.enterProcLayer();//ڲ
+			Symbol* proc = symTable.insertProc(procName, param_count,pcode.PC);//插入过程
+			SymLayer* layer =  symTable.enterProcLayer();//进入过程内层
 
-			proc->attr_.proc_attr.layer_ptr = layer;//̷ָ̲
-			proc->attr_.proc_attr.entry_addr = pcode.PC;//дڵַ
-			symTable.current_layer_->setLayerName(procName);//д
+			proc->attr_.proc_attr.layer_ptr = layer;//过程符号指向过程层
+			proc->attr_.proc_attr.entry_addr = pcode.PC;//填写过程入口地址
+			symTable.current_layer_->setLayerName(procName);//填写过程名字
 
-			//
+			//插入参数
 			symName.erase(symName.begin());
 			for (const auto& name : symName) {
 				symTable.insertParam(name);
 			}
 
 			symName.clear();
+			symPos.clear();
 
-			/*2. pcode {ɹתָ}*/
+			/*2. pcode {生成过程入口跳转指令}*/
 			pcode.addJump();
-			pcode.emit("JMP", 0, 0); //ַ
+			pcode.emit(op::JMP, 0, 0); //地址待回填
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_out_proc") {
-			/*1. ű˳*/
-			symTable.exitProcLayer();//˳ڲ
+			/*1. 符号表：退出过程*/
+			symTable.exitProcLayer();//退出过程内层
 		
 
-			/*2. pcode ɹ̷ָ*/
-			pcode.emit("OPR", 0, 0); // ̷ָ
+			/*2. pcode 生成过程返回指令*/
+			pcode.emit(op::RET, 0, 0); // 过程返回指令
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_begin_body") {
-			/*pcodeתָ*/
+			/*回填pcode入口跳转指令*/
 			pcode.fillJump(pcode.PC);
 			
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_assignment") {
-			/* P룺ɸֵָ 
+			/* P代码：生成赋值指令 
 			Code[PC++] = { STO, L, A };*/
-			int level_diff;
-			Symbol* var_sym = symTable.findGlobal(symName.back(), level_diff);
-			//ֵ
-			if (var_sym->getType() != SYMBOLTYPE::PARAM && var_sym->getType() != SYMBOLTYPE::VAR) {
-				cerr << line_num << ",ڸֵ" << symName.back() << "Ǳ" << endl;
+			int level_diff = 0;
+			//左值类型由语义检查遍检查
+			Symbol* var_sym = lookupSymbolOrRecord(symName.back(), symPos.back(), RefKind::ASSIGN, level_diff);
+			if (var_sym != nullptr && (var_sym->getType() == SYMBOLTYPE::PARAM || var_sym->getType() == SYMBOLTYPE::VAR)) {
+				pcode.emit(op::STO, var_sym->getLevel(), var_sym->getOffset());
+			}
+			else {
+				emitPlaceholder(op::STO, symName.back(), symPos.back(), " 不是变量或参数，不能赋值");
 			}
-
 			symName.pop_back();
-			pcode.emit("STO", var_sym->getLevel(), var_sym->getOffset());
+			symPos.pop_back();
 
 			state = "";
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_if") {
-			//pcode ifͷת
-			pcode.newLabel("if_JPC", pcode.PC);
-			pcode.emit("JPC", 0, 0);//
+			//pcode if开头跳转控制（条件为常量时折叠）
+			pcode.emitCondJump("if_JPC");
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_else_if") {
 			
-			//thenתָ
+			//生成then跳转指令
 			pcode.newLabel("else_JMP", pcode.PC);
-			pcode.emit("JMP", 0, 0);//
-			//if JPC
+			pcode.emit(op::JMP, 0, 0);//待回填
+			//回填if JPC
 			pcode.backPatch("if_JPC", pcode.PC);
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_end_else") {
-			//else JMP
+			//回填else JMP
 			pcode.backPatch("else_JMP", pcode.PC);
 
 
@@ -448,26 +478,25 @@ public:
 			return true;
 		}
 		if(symbol == "_begin_while") {
-			//¼whileʼַ
+			//记录while开始地址
 			begin_while.push_back(pcode.PC);
+			pcode.markTarget(pcode.PC);
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_while") {
-			//ɱǩ
-			pcode.newLabel("while_JPC", pcode.PC);
-			/*while תָJPC*/
-			pcode.emit("JPC", 0, 0);//
+			/*生成while 跳转指令JPC并生成标签（条件为常量时折叠）*/
+			pcode.emitCondJump("while_JPC");
 
 			symbols.erase(symbols.begin());
 			return true;
 			
 		}
 		if (symbol == "_end_while") {
-			//תwhileʼַָJMP
-			pcode.emit("JMP", 0, begin_while.back());
+			//生成跳转回while开始地址指令JMP
+			pcode.emit(op::JMP, 0, begin_while.back());
 			begin_while.pop_back();
-			//while תָJPC
+			//回填while 跳转指令JPC
 			pcode.backPatch("while_JPC", pcode.PC);
 
 			state = "";
@@ -475,43 +504,48 @@ public:
 			return true;
 		}
 		if (symbol == "_call") {
-			//pcode callָ
+			//pcode 生成call指令
 			string procName = symName.back();
-			symName.pop_back();
 			int level_diff = 0;
-			Symbol* proc_sym = symTable.findGlobal(procName, level_diff);
-			//βθ
-			if (arg_count != proc_sym->attr_.proc_attr.param_count) {
-				cerr << line_num << "," << procName << "ʱƥ䣬ʱΪ"
-					<< proc_sym->attr_.proc_attr.param_count << "ʱΪ" << arg_count << endl;
-			}
-			//STOָ
+			//形参个数由语义检查遍检查
+			Symbol* proc_sym = lookupSymbolOrRecord(procName, symPos.back(), RefKind::CALL, level_diff, arg_count);
+			SrcPos callPos = symPos.back();
+			symName.pop_back();
+			symPos.pop_back();
+			//生成STO指令
 			for(int i=0;i<arg_count;i++) {
-				pcode.emit("STO", -1, i, arg_count - i - 1);
+				pcode.emit(op::STO, -1, i, arg_count - i - 1);
 			}
 
-			pcode.emit("CAL", level_diff, proc_sym->getProcEntryAddr());
-			arg_count = 0;//ղ
+			if (proc_sym != nullptr && proc_sym->getType() == SYMBOLTYPE::PROC) {
+				pcode.emit(op::CAL, level_diff, proc_sym->getProcEntryAddr());
+			}
+			else {
+				emitPlaceholder(op::CAL, procName, callPos, " 不是可调用的过程");
+			}
+			arg_count = 0;//清空参数个数
 
 			state = "";
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_read") {
-			//ÿRED+STOָ,ѹջֵ
-			for (auto x : symName) {
-				pcode.emit("RED", 0, 0);
+			//对每个变量生成RED+STO指令,读整数，压入栈顶，赋值
+			for (size_t i = 0; i < symName.size(); i++) {
+				pcode.emit(op::RED, 0, 0);
 				int level_diff = 0;
-				Symbol* sym = symTable.findGlobal(x, level_diff);
+				// 只允许变量或参数作为 read 的目标，由语义检查遍检查
+				Symbol* sym = lookupSymbolOrRecord(symName[i], symPos[i], RefKind::READ, level_diff);
 
-				// ֻΪ read Ŀ
-				if (sym->getType() != SYMBOLTYPE::VAR && sym->getType() != SYMBOLTYPE::PARAM) {
-					reportSemanticError(sym->getName() + " ǱΪ read Ŀ", currentToken);
+				if (sym != nullptr && (sym->getType() == SYMBOLTYPE::VAR || sym->getType() == SYMBOLTYPE::PARAM)) {
+					pcode.emit(op::STO, sym->getLevel(), sym->getOffset());//与赋值语句一致
+				}
+				else {
+					emitPlaceholder(op::STO, symName[i], symPos[i], " 不是变量，不能作为 read 的目标");
 				}
-
-				pcode.emit("STO", level_diff, sym->getOffset() + 3);
 			}
 			symName.clear();
+			symPos.clear();
 
 			state = "";
 			symbols.erase(symbols.begin());
@@ -519,8 +553,8 @@ public:
 		}
 		if (symbol == "_write") {
 			while (arg_count-- > 0) {
-			//pcode WRTָ
-				pcode.emit("WRT", 0, 0);
+			//pcode 生成WRT指令
+				pcode.emit(op::WRT, 0, 0);
 			}
 
 			state = "";
@@ -528,22 +562,25 @@ public:
 			return true;
 		}
 		if (symbol == "_exp_explist") {
-			arg_count++;//¼,callwrite
+			arg_count++;//记录参数个数,用于call和write
 			
 			symbols.erase(symbols.begin());
 			return true;
 		}
 
 		if (symbol == "_oddlexp") {
-			/* P룺ODD㣨OPR 0 6 */
-			pcode.emit("OPR", 0, 6);
+			/* P代码：生成ODD运算（OPR 0 6） */
+			pcode.emitOpr(op::ODD);
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_cmplexp") {
-			/* P룺ɹϵOPRָ */
-			pcode.emit("OPR", 0, tmplop.back());
+			/* P代码：生成关系运算OPR指令 */
+			op cmp;
+			if (oprFromCode(tmplop.back(), cmp)) {
+				pcode.emitOpr(cmp);
+			}
 			tmplop.pop_back();
 
 			symbols.erase(symbols.begin());
@@ -553,62 +590,61 @@ public:
 			string a = aop.back();
 			aop.pop_back();
 			if (a == "+") {
-				pcode.emit("OPR", 0, 2);
+				pcode.emitOpr(op::ADD);
 			}
 			else if (a == "-") {
-				pcode.emit("OPR", 0, 3);
+				pcode.emitOpr(op::SUB);
 			}
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_mop_term") {
-			//pcode ɳ˳ָ
+			//pcode 生成乘除指令
 			string m = mop.back();
 			mop.pop_back();
 			if(m == "*") {
-				pcode.emit("OPR", 0, 4);
+				pcode.emitOpr(op::MUL);
 			}
 			else if (m == "/") {
-				pcode.emit("OPR", 0, 5);
+				pcode.emitOpr(op::DIV);
 			}
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_integer_factor") {
-			/* P룺ɼسָ 
+			/* P代码：生成加载常量指令 
 			Code[PC++] = { LIT, 0, value };*/
 			int value = stoi(symValue.back());
 			symValue.pop_back();
-			pcode.emit("LIT", 0, value);
+			pcode.emit(op::LIT, 0, value);
 
 			symbols.erase(symbols.begin());
 			return true;
 		}
 		if (symbol == "_id_factor") {
-			/* P룺ɼر//ָ  سָ
-				Գ LIT ָԱ/ LOD ָ */
+			/* P代码：生成加载变量/常量/参数指令 或 加载常量指令
+				对常量生成 LIT 指令；对变量/参数生成 LOD 指令。 */
 
-			// ҷţδ lookupSymbolOrReport бֹ
+			// 查找符号（未定义或过程作为因子由语义检查遍报告）
 			int diff = 0;
-			Symbol* sym = lookupSymbolOrReport(symName.back(), currentToken);
-			symName.pop_back();
+			Symbol* sym = lookupSymbolOrRecord(symName.back(), symPos.back(), RefKind::FACTOR, diff);
 
-			// 鲻ܰѹΪ
-			if (sym->getType() == SYMBOLTYPE::PROC) {
-				reportSemanticError(sym->getName() + " ṇ̀Ϊ", currentToken);
+			// 根据符号类型分别生成 Pcode
+			if (sym == nullptr || sym->getType() == SYMBOLTYPE::PROC) {
+				emitPlaceholder(op::LIT, symName.back(), symPos.back(), " 未定义或是过程，不能作为因子");
 			}
-
-			// ݷͷֱ Pcode
-			if (sym->getType() == SYMBOLTYPE::Const) {
-				// ֱӰѳֵΪ
-				pcode.emit("LIT", 0, sym->getConstVal());
+			else if (sym->getType() == SYMBOLTYPE::Const) {
+				// 常量：直接把常量值作为字面量加载
+				pcode.emit(op::LIT, 0, sym->getConstVal());
 			}
 			else {
-				// ӦƫƼ
-				pcode.emit("LOD", sym->getLevel(), sym->getOffset());
+				// 变量或参数：从相应层和偏移加载
+				pcode.emit(op::LOD, sym->getLevel(), sym->getOffset());
 			}
+			symName.pop_back();
+			symPos.pop_back();
 
 			symbols.erase(symbols.begin());
 			return true;
@@ -616,10 +652,10 @@ public:
 
 
 
-		//ս.................................................
+		//非终结符处理.................................................
 		
 		if (symbol == "<prog>") {
-			//ʽ <prog> "program" ID  "_prog"  ";" <block> "_end_prog"
+			//产生式 <prog> →"program" ID  "_prog"  ";" <block> "_end_prog"
 			if (currentToken.type == TokenType::PROGRAM) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "_end_prog");
@@ -638,7 +674,7 @@ public:
 		}
 
 		if (symbol == "<block>") {
-			//<block>  <condecl_opt> <vardecl_opt> <proc_opt> "_begin_body"  <body> 
+			//<block> → <condecl_opt> <vardecl_opt> <proc_opt> "_begin_body"  <body> 
 			//first:  "const", "var", "procedure", "begin"
 
 			if (currentToken.type == TokenType::CONST ||
@@ -659,21 +695,21 @@ public:
 
 		}
 		if (symbol == "<condecl_opt>") {
-			//<condecl_opt>  <condecl> |  
-			//first: "const", 
+			//<condecl_opt> → <condecl> | ε 
+			//first: "const", ε
 			if (currentToken.type == TokenType::CONST) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<condecl>");
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<condecl>") {
-			//<condecl>  "const" < const_list > ";"
+			//<condecl> → "const" < const_list > ";"
 			if (currentToken.type == TokenType::CONST) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "SEMICOLON");
@@ -688,7 +724,7 @@ public:
 
 		}
 		if (symbol == "<const_list>") {
-			//<const_list>  <const>  "_const" <const_list_tail>
+			//<const_list> → <const>  "_const" <const_list_tail>
 			//first : ID
 			if (currentToken.type == TokenType::IDENTIFIER) {
 				symbols.erase(symbols.begin());
@@ -702,7 +738,7 @@ public:
 			}
 		}
 		if (symbol == "<const>") {
-			//<const> ID ":=" < integer >
+			//<const>→ ID ":=" < integer >
 			if (currentToken.type == TokenType::IDENTIFIER) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "INTEGER");
@@ -716,8 +752,8 @@ public:
 			}
 		}
 		if (symbol == "<const_list_tail>") {
-			//<const_list_tail>  "," <const>  "_const"  <const_list_tail> |  
-			//first: ",", 
+			//<const_list_tail> → "," <const>  "_const"  <const_list_tail> | ε 
+			//first: ",", ε
 			if (currentToken.type == TokenType::COMMA) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<const_list_tail>");
@@ -727,28 +763,28 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 
 		if (symbol == "<vardecl_opt>") {
-			//<vardecl_opt>  <vardecl> |  
-			//first ; "var", 
+			//<vardecl_opt> → <vardecl> | ε 
+			//first ; "var", ε
 			if (currentToken.type == TokenType::VAR) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<vardecl>");
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<vardecl>") {
-			//<vardecl>  "var" < id_list >  "_var"  ";"
+			//<vardecl> → "var" < id_list >  "_var"  ";"
 			if (currentToken.type == TokenType::VAR) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "SEMICOLON");
@@ -763,21 +799,21 @@ public:
 		}
 
 		if (symbol == "<proc_opt>") {
-			//<proc_opt>   <proc> |  
-			//first: "procedure", 
+			//<proc_opt>  → <proc> | ε 
+			//first: "procedure", ε
 			if (currentToken.type == TokenType::PROCEDURE) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<proc>");
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<proc>") {
-			//<proc>  "procedure" ID <param_list_opt>  "_proc"  ";" <block>   "_out_proc"  <proc_tail> 
+			//<proc> → "procedure" ID <param_list_opt>  "_proc"  ";" <block>   "_out_proc"  <proc_tail> 
 			if (currentToken.type == TokenType::PROCEDURE) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<proc_tail>");
@@ -795,7 +831,7 @@ public:
 			}
 		}
 		if (symbol == "<param_list_opt>") {
-			//<param_list_opt>  "(" < id_list_opt >  ")"
+			//<param_list_opt> → "(" < id_list_opt >  ")"
 			if (currentToken.type == TokenType::LPAREN) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "RPAREN");
@@ -808,22 +844,22 @@ public:
 			}
 		}
 		if (symbol == "<id_list_opt>") {
-			//<id_list_opt>  <id_list> | 
-			//first: ID, 
+			//<id_list_opt> → <id_list> | ε
+			//first: ID, ε
 			if (currentToken.type == TokenType::IDENTIFIER) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<id_list>");
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<proc_tail>") {
-			//<proc_tail>  ";" < proc > | 
-			//first: ";", 
+			//<proc_tail> → ";" < proc > | ε
+			//first: ";", ε
 			if (currentToken.type == TokenType::SEMICOLON) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<proc>");
@@ -831,14 +867,14 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		
 		if (symbol == "<body>") {
-			//<body> "begin" <statement_list> "end" 
+			//<body>→ "begin" <statement_list> "end" 
 			if (currentToken.type == TokenType::BEGIN) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "END");
@@ -851,7 +887,7 @@ public:
 			}
 		}
 		if (symbol == "<statement_list>") {
-			//<statement_list>  <statement> <statement_tail>
+			//<statement_list> → <statement> <statement_tail>
 			//first: ID, "if", "while", "call", "begin", "read", "write"
 			if (currentToken.type == TokenType::IDENTIFIER ||
 				currentToken.type == TokenType::IF ||
@@ -870,8 +906,8 @@ public:
 			}
 		}
 		if (symbol == "<statement_tail>") {
-			//<statement_tail>  ";" <statement> <statement_tail> |  
-			//first: ";", 
+			//<statement_tail> → ";" <statement> <statement_tail> | ε 
+			//first: ";", ε
 			if (currentToken.type == TokenType::SEMICOLON) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<statement_tail>");
@@ -880,20 +916,20 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 
 		if (symbol == "<statement>") {
-			/*<statement>     ID    ":=" <exp>  "_assignment"  // ֵ
-			| "if"   < lexp >  "_if"  "then" < statement > "_else_if" <else_opt> "_end_else"     // 
-			| <while_stmt>     // ѭ䣨ͣ
-			| <call_stmt>      // ̵
-			| <body>           // Ƕ׸
-			| <read_stmt>      // 
-			| <write_stmt>     // 
+			/*<statement>   →  ID    ":=" <exp>  "_assignment"  // 赋值语句
+			| "if"   < lexp >  "_if"  "then" < statement > "_else_if" <else_opt> "_end_else"     // 条件语句
+			| <while_stmt>     // 循环语句（当型）
+			| <call_stmt>      // 过程调用语句
+			| <body>           // 嵌套复合语句
+			| <read_stmt>      // 输入语句
+			| <write_stmt>     // 输出语句
 			*/
 			//first: ID, "if", "while", "call", "begin", "read", "write"
 			if (currentToken.type == TokenType::IDENTIFIER) {
@@ -960,8 +996,8 @@ public:
 
 		}
 		if (symbol == "<else_opt>") {
-			//<else_opt>  "else" < statement > |  
-			//first: "else", 
+			//<else_opt> → "else" < statement > | ε 
+			//first: "else", ε
 			if (currentToken.type == TokenType::ELSE) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<statement>");
@@ -969,14 +1005,14 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 
 		if (symbol == "<while_stmt>") {
-			//<while_stmt>   "while" "_begin_while"  " <lexp> "_while"  "do" <statement> "_end_while"
+			//<while_stmt>  → "while" "_begin_while"  " <lexp> "_while"  "do" <statement> "_end_while"
 			if (currentToken.type == TokenType::WHILE) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "_end_while");
@@ -997,7 +1033,7 @@ public:
 		}
 		
 		if (symbol == "<lexp>") {
-			//<lexp> <odd_lexp> | <cmp_lexp>  
+			//<lexp>→ <odd_lexp> | <cmp_lexp>  
 			//first: "odd" , ID, <integer>, "(", "+", "-"
 			if (currentToken.type == TokenType::ODD) {
 				symbols.erase(symbols.begin());
@@ -1018,7 +1054,7 @@ public:
 		}
 
 		if (symbol == "<odd_lexp>") {
-			//<odd_lexp>  "odd" < exp >  "_oddlexp"  
+			//<odd_lexp> → "odd" < exp >  "_oddlexp"  
 			if (currentToken.type == TokenType::ODD) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "_oddlexp");
@@ -1031,7 +1067,7 @@ public:
 			}
 		}
 		if (symbol == "<exp>"){
-			//<exp> <sign_opt> <term>   <exp_tail>
+			//<exp>→ <sign_opt> <term>   <exp_tail>
 			//first: AOP, ID, <integer>, "("
 			if (currentToken.type == TokenType::AOP ||
 				currentToken.type == TokenType::IDENTIFIER ||
@@ -1050,21 +1086,21 @@ public:
 
 		}
 		if (symbol == "<sign_opt>") {
-			//<sign_opt>  AOP   |  
-			//first: AOP, 
+			//<sign_opt> → AOP   | ε 
+			//first: AOP, ε
 			if (currentToken.type == TokenType::AOP) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "AOP");
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<term>") {
-			//<term>  <factor> <term_tail>
+			//<term> → <factor> <term_tail>
 			//first: ID, <integer>, "("
 			if (currentToken.type == TokenType::IDENTIFIER ||
 				currentToken.type == TokenType::INTEGER ||
@@ -1079,7 +1115,7 @@ public:
 			}
 		}
 		if (symbol == "<factor>") {
-			/*<factor>  ID  "_id_factor"
+			/*<factor> → ID  "_id_factor"
 			 | <integer>  "_interger_factor" 
 			 | "(" <exp> ")"
 			 */
@@ -1109,8 +1145,8 @@ public:
 		}
 
 		if (symbol ==  "<exp_tail>") {
-			//<exp_tail>  AOP <term>  "_aop_exp"  <exp_tail> |  
-			//first: AOP, 
+			//<exp_tail> → AOP <term>  "_aop_exp"  <exp_tail> | ε 
+			//first: AOP, ε
 			if (currentToken.type == TokenType::AOP) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<exp_tail>");
@@ -1121,14 +1157,14 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<term_tail>") {
-			//<term_tail>  MOP <factor> "_mop_term"   <term_tail> |    
-			//first: MOP, 
+			//<term_tail> → MOP <factor> "_mop_term"   <term_tail> | ε   
+			//first: MOP, ε
 			if (currentToken.type == TokenType::MOP) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<term_tail>");
@@ -1139,14 +1175,14 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 
 		if (symbol == "<cmp_lexp>") {
-			//<cmp_lexp>  <exp> LOP <exp> "_cmplexp"
+			//<cmp_lexp> → <exp> LOP <exp> "_cmplexp"
 			//first: ID, <integer>, "(", AOP
 			if (currentToken.type == TokenType::IDENTIFIER ||
 				currentToken.type == TokenType::INTEGER ||
@@ -1166,10 +1202,10 @@ public:
 		
 
 		if (symbol == "<call_stmt>") {
-			//<call_stmt>  "call" ID <arg_list_opt> "_call"
+			//<call_stmt> → "call" ID <arg_list_opt> "_call"
 			if (currentToken.type == TokenType::CALL) {
 				symbols.erase(symbols.begin());
-				arg_count = 0;//ʼ
+				arg_count = 0;//初始化参数个数
 				symbols.insert(symbols.begin(), "_call");
 				symbols.insert(symbols.begin(), "<arg_list_opt>");
 				symbols.insert(symbols.begin(), "ID");
@@ -1181,7 +1217,7 @@ public:
 			}
 		}
 		if (symbol == "<arg_list_opt>") {
-			//<arg_list_opt>  "(" <exp_list_opt> ")" | 
+			//<arg_list_opt> → "(" <exp_list_opt> ")" | ε
 			if (currentToken.type == TokenType::LPAREN) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "RPAREN");
@@ -1190,14 +1226,14 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<exp_list_opt>") {
-			//<exp_list_opt>  <exp_list> | 
-			//first: ID, <integer>, "(", AOP, 
+			//<exp_list_opt> → <exp_list> | ε
+			//first: ID, <integer>, "(", AOP, ε
 			if (currentToken.type == TokenType::IDENTIFIER ||
 				currentToken.type == TokenType::INTEGER ||
 				currentToken.type == TokenType::LPAREN ||
@@ -1207,13 +1243,13 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
 		}
 		if (symbol == "<exp_list>") {
-			//<exp_list>  <exp> "_exp_explist" <exp_list_tail>
+			//<exp_list> → <exp> "_exp_explist" <exp_list_tail>
 			//first: ID, <integer>, "(", AOP
 			if (currentToken.type == TokenType::IDENTIFIER ||
 				currentToken.type == TokenType::INTEGER ||
@@ -1230,8 +1266,8 @@ public:
 			}
 		}
 		if (symbol == "<exp_list_tail>") {
-			//<exp_list_tail>  "," <exp> _exp_explist <exp_list_tail> | 
-			//first: ",", 
+			//<exp_list_tail> → "," <exp> _exp_explist <exp_list_tail> | ε
+			//first: ",", ε
 			if (currentToken.type == TokenType::COMMA) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<exp_list_tail>");
@@ -1242,7 +1278,7 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
@@ -1250,7 +1286,7 @@ public:
 
 
 		if (symbol ==  "<read_stmt>") {
-			//<read_stmt>    "read" "(" < id_list > ")"   "_read"
+			//<read_stmt>   → "read" "(" < id_list > ")"   "_read"
 			if (currentToken.type == TokenType::READ) {
 				symbols.erase(symbols.begin());
 
@@ -1267,7 +1303,7 @@ public:
 			}
 		}
 		if (symbol == "<id_list>") {
-			//<id_list>  ID  <id_list_tail>
+			//<id_list> → ID  <id_list_tail>
 			if (currentToken.type == TokenType::IDENTIFIER) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<id_list_tail>");
@@ -1279,7 +1315,7 @@ public:
 			}
 		}
 		if (symbol == "<id_list_tail>") {
-			//<id_list_tail>  "," ID <id_list_tail> | 
+			//<id_list_tail> → "," ID <id_list_tail> | ε
 			if (currentToken.type == TokenType::COMMA) {
 				symbols.erase(symbols.begin());
 				symbols.insert(symbols.begin(), "<id_list_tail>");
@@ -1289,7 +1325,7 @@ public:
 				return true;
 			}
 			else {
-				//Ųʽ
+				//ε产生式
 				symbols.erase(symbols.begin());
 				return true;
 			}
@@ -1297,12 +1333,12 @@ public:
 
 
 		if (symbol == "<write_stmt>") {
-			//<write_stmt>   "write" "(" < exp_list >  ")"  "_write"
+			//<write_stmt>  → "write" "(" < exp_list >  ")"  "_write"
 			if (currentToken.type == TokenType::WRITE) {
 				state = "write";
 
 				symbols.erase(symbols.begin());
-				arg_count = 0;//ʼ
+				arg_count = 0;//初始化参数个数
 				symbols.insert(symbols.begin(), "_write");
 				symbols.insert(symbols.begin(), "RPAREN");
 				symbols.insert(symbols.begin(), "<exp_list>");
@@ -1316,7 +1352,7 @@ public:
 		}
 
 		else {
-			cerr << "δ֪: " << symbol << endl;
+			cerr << "未知符号: " << symbol << endl;
 			return false;
 		}
 	}
@@ -1324,7 +1360,7 @@ public:
 
 
 	void parse() {
-		cout << "\nʼ﷨,pcodeɣű... " << endl;
+		cout << "\n开始语法分析,语义分析，pcode生成，符号表生成... " << endl;
 
 		currentToken = getNextToken();
 		while (!symbols.empty()) {
@@ -1332,17 +1368,17 @@ public:
 			//cout << symbol <<"|" << currentToken.value << endl;
 			if(!match(symbol)){
 				FirstSet fs;
-				cerr << "\n﷨" << endl;
-				/*cerr << "  (" << currentToken.row << ","
-					<< currentToken.column << ")Ч'" << currentToken.value << "'" << endl;
-				cerr << "Ϊ:" << symbol<<" ";
+				cerr << "\n碰到语法错误" << endl;
+				/*cerr << "  在(" << currentToken.row << ","
+					<< currentToken.column << ")处，遇到无效符号'" << currentToken.value << "'" << endl;
+				cerr << "期望符号为:" << symbol<<" ";
 				fs.printFirstSet(symbol);
 				exit(0);*/
 
 
-				//panic_mode
+				//错误修正和panic_mode
 				if (rectify_mode) {
-					cout << "Դ...";
+					cout << "尝试错误修正...";
 					vector<string> expected_tokens = fs.getFirstSet(symbol);
 					bool corrected = false;
 					auto it = rectifyTokens.find(symbol);
@@ -1350,8 +1386,8 @@ public:
 						
 						Token tmpt = currentToken;
 						currentToken.type = typeMap[it->first];
-						cout<< "(" << currentToken.row << ", "<< currentToken.column << ")"
-							<<tmpt.value << "ǰӷ" << it->second << "  "<<endl;
+						cout<< "在(" << currentToken.row << ", "<< currentToken.column << ")"
+							<<tmpt.value << "前添加符号" << it->second << "。  "<<endl;
 						back_token = true;
 						if (match(symbol)) {
 							corrected = true;
@@ -1376,8 +1412,8 @@ public:
 
 									Token tmpt = currentToken;
 									currentToken.type = typeMap[it->first];
-									cout << "(" << currentToken.row << ", " << currentToken.column << ")"
-										<< tmpt.value << "ǰӷ" << it->second << "  " << endl;
+									cout << "在(" << currentToken.row << ", " << currentToken.column << ")"
+										<< tmpt.value << "前添加符号" << it->second << "。  " << endl;
 									back_token = true;
 									if (match(symbol)) {
 										corrected = true;
@@ -1393,7 +1429,7 @@ public:
 					if (corrected == false) {
 						
 						if (panic_mode) {
-							cout << "ʧܣpanic modeָ..." << endl;
+							cout << "错误修正失败，进入panic mode错误恢复..." << endl;
 							if (panicstates.find(state) != panicstates.end()) {
 								vector<string> v = panicstatemap[state];
 								vector<string>::iterator it;
@@ -1423,19 +1459,19 @@ public:
 							}
 							
 							else {
-								cout << "ش!" << endl;
+								cout << "严重错误!" << endl;
 
-								cerr << "Ϊ:" << symbol;
+								cerr << "期望符号为:" << symbol;
 								fs.printFirstSet(symbol);
 						
 								exit(0);
 							}
 						}
 						else {
-							cerr << "޸ʧ" << endl;
-							cerr << "  (" << currentToken.row << ","
-								<< currentToken.column << ")Ч'" << currentToken.value << "'" << endl;
-							cerr << "Ϊ:" << symbol<<" ";
+							cerr << "修复失败" << endl;
+							cerr << "  在(" << currentToken.row << ","
+								<< currentToken.column << ")处，遇到无效符号'" << currentToken.value << "'" << endl;
+							cerr << "期望符号为:" << symbol<<" ";
 							fs.printFirstSet(symbol);
 							exit(0);
 						}
@@ -1448,12 +1484,34 @@ public:
 			}
 		}
 
-		cout << "\n\n﷨ɹԴ﷨" << endl;
-		cout << "űpcodeϣ\n\n" << endl;
+		cout << "\n\n语法分析成功，源程序符合语法规则！" << endl;
+
+		//声明已全部收集，按过程并行做语义检查
+		reportSemanticErrors(semChecker.check(symTable));
+		if (fold_mode) {
+			cout << "常量折叠消除指令 " << pcode.folded << " 条" << endl;
+		}
+		Optimizer opt;
+		if (dce_mode) {
+			opt.eliminateDeadCode(pcode, symTable);
+			opt.printReport();
+		}
+		if (peephole_mode) {
+			opt.peephole(pcode, symTable);
+			opt.printPeepholeReport();
+		}
+		if (super_mode) {//最后进行，之后不再有按单条指令改写的优化
+			opt.selectSuperinstructions(super_profile, super_top);
+			opt.superinstructions(pcode);
+			opt.printSuperReport();
+		}
+		cout << "符号表建立，pcode生成完毕！\n\n" << endl;
 
 		pcode.printCode();
 
 		pcode.printCodeFile("pcode.txt");
+		pcode.printDebugFile(symTable, debugFileOf("pcode.txt"));
+		pcode.printImageFile(symTable, "pcode.img");
 		//pcode.interpret(symTable);
 		
 	}
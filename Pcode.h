@@ -4,280 +4,536 @@
 #include<vector>
 #include<string>
 #include<fstream>
-// ͷļֱʽ
+// 包含反向迭代器所需头文件（部分编译器需显式包含）
 #include<iterator>
+#include<cstdint>
+#include<chrono>
+#include<sstream>
+#include<climits>
 #include"SymbolTable.h"
+#include"DebugInfo.h"
+#include"Trace.h"
+#include"Profile.h"
+#include"IO.h"
+#include"config.h"
+
+// GCC/Clang 支持标签地址（&&label、goto *p），解释器可使用直接线索化分派
+#if defined(__GNUC__) || defined(__clang__)
+#define PL0_THREADED
+#endif
 
 using namespace std;
 
 fstream File;
 
-bool key = false;//ڵ
-vector<int> write_result;//д
+bool key = false;//用于调试
 
 /*
-F,L,A ʽָ
-Fα
-Lζ
-AλԵַ
+F,L,A 三段式指令
+F段伪操作码
+L段定义层
+A段位移量（相对地址）
+OPR 按A段拆分为独立操作码，比较后条件跳转拆分为JPC系列；文本形式仍为 OPR 0 A / JPC L A
 */
-enum class op {
-	LIT,  // ջLoad Literal
-	LOD,  // /ջLoad
-	STO,  // ջֵ/Store
-	CAL,  // ̵ãCall
-	INT,  // Allocate Integer
-	JMP,  // תJump
-	JPC,  // תJump on Condition
-	OPR,  // /Operation
-	RED,  // ֵջRead
-	WRT,  // ջֵWrite
+enum class op : uint8_t {
+	LIT,  // 常量入栈（Load Literal）
+	LOD,  // 变量/参数入栈（Load）
+	STO,  // 栈顶值存入变量/参数（Store）
+	CAL,  // 过程调用（Call）
+	INT,  // 开辟数据区（Allocate Integer）
+	JMP,  // 无条件跳转（Jump）
+	JPC,  // 条件跳转（Jump on Condition）
+	RED,  // 读入值入栈（Read）
+	WRT,  // 栈顶值输出（Write）
+
+	// OPR 子操作，括号内为文本形式的A段
+	RET,  // 过程返回（0）
+	NEG,  // 取负（1）
+	ADD,  // 加法（2）
+	SUB,  // 减法（3）
+	MUL,  // 乘法（4）
+	DIV,  // 除法（5）
+	ODD,  // 奇偶判断（6）
+	EQ,   // 相等（7）
+	NE,   // 不等（8）
+	LT,   // 小于（9）
+	LE,   // 小于等于（10）
+	GT,   // 大于（11）
+	GE,   // 大于等于（12）
+	DUP,  // 复制栈顶（13）
+
+	// 比较后条件跳转（JPC 比较码 A），比较结果为假时跳转
+	JPCEQ, JPCNE, JPCLT, JPCLE, JPCGT, JPCGE,
+
+	// 超级指令：序列首条指令的操作码改为超级指令，L、A不变，其后各条原样保留作为操作数
+	LLOS, // LOD a; LIT k; OPR op; STO b
+	LDOS, // LOD a; LOD b; OPR op; STO c
+	LLO,  // LOD a; LIT k; OPR op
+	LDO,  // LOD a; LOD b; OPR op
+	LLJ,  // LOD a; LIT k; JPC cmp A
+	LDJ,  // LOD a; LOD b; JPC cmp A
+	LSTO, // LIT k; STO a
+
+	COUNT // 操作码个数
 };
 
+// OPR A段 <-> 操作码
+const int OPR_CODE_MAX = 13;
+bool oprFromCode(int a, op& out) {
+	if (a < 0 || a > OPR_CODE_MAX) return false;
+	out = static_cast<op>(static_cast<int>(op::RET) + a);
+	return true;
+}
+bool isOpr(op f) { return f >= op::RET && f <= op::DUP; }
+int oprCode(op f) { return static_cast<int>(f) - static_cast<int>(op::RET); }
+
+// 关系运算 <-> 比较后条件跳转
+bool isCmp(op f) { return f >= op::EQ && f <= op::GE; }
+bool isCmpJump(op f) { return f >= op::JPCEQ && f <= op::JPCGE; }
+op cmpJump(op cmp) { return static_cast<op>(static_cast<int>(op::JPCEQ) + (static_cast<int>(cmp) - static_cast<int>(op::EQ))); }
+op jumpCmp(op f) { return static_cast<op>(static_cast<int>(op::EQ) + (static_cast<int>(f) - static_cast<int>(op::JPCEQ))); }
+
+// A段为代码地址的指令
+bool hasTarget(op f) { return f == op::JMP || f == op::JPC || f == op::CAL || isCmpJump(f); }
+
+// 二元运算（算术、关系）
+bool isBinary(op f) { return (f >= op::ADD && f <= op::DIV) || isCmp(f); }
+
+// 超级指令覆盖的指令条数及其首条指令原来的操作码
+bool isSuper(op f) { return f >= op::LLOS && f <= op::LSTO; }
+int superLen(op f) {
+	switch (f) {
+	case op::LLOS: case op::LDOS: return 4;
+	case op::LSTO: return 2;
+	default: return 3;
+	}
+}
+op superHead(op f) {
+	if (!isSuper(f)) return f;
+	return f == op::LSTO ? op::LIT : op::LOD;
+}
+
 struct label {
 	string id;
-	int place; // ǩӦַָ
+	int place; // 标签对应的指令地址
 };
 
-// Ƕ׽ṹ壺Pcodeָṹ
+// 嵌套结构体：Pcode指令结构，8字节
 typedef struct Instruction {
-	string op = ""; // 
-	int L = 0;      // ֵ
-	int A = 0;      // λԵַ
+	op f = op::LIT;   // 操作码
+	int16_t L = 0;    // 层差值
+	int32_t A = 0;    // 位移量（相对地址）
 }Ins;
+static_assert(sizeof(Ins) == 8, "Ins 应为8字节");
+
+// 指令助记符（文本形式）
+const char* opName(op f) {
+	switch (f) {
+	case op::LIT: return "LIT";
+	case op::LOD: return "LOD";
+	case op::STO: return "STO";
+	case op::CAL: return "CAL";
+	case op::INT: return "INT";
+	case op::JMP: return "JMP";
+	case op::RED: return "RED";
+	case op::WRT: return "WRT";
+	case op::LLOS: return "LLOS";
+	case op::LDOS: return "LDOS";
+	case op::LLO: return "LLO";
+	case op::LDO: return "LDO";
+	case op::LLJ: return "LLJ";
+	case op::LDJ: return "LDJ";
+	case op::LSTO: return "LSTO";
+	default:
+		if (isOpr(f)) return "OPR";
+		return "JPC";
+	}
+}
+
+// 操作码名，OPR、JPC系列各自区分（剖析报告按此分组）
+const char* opLabel(op f) {
+	static const char* const names[] = {
+		"LIT", "LOD", "STO", "CAL", "INT", "JMP", "JPC", "RED", "WRT",
+		"RET", "NEG", "ADD", "SUB", "MUL", "DIV", "ODD", "EQ", "NE", "LT", "LE", "GT", "GE", "DUP",
+		"JPCEQ", "JPCNE", "JPCLT", "JPCLE", "JPCGT", "JPCGE",
+		"LLOS", "LDOS", "LLO", "LDO", "LLJ", "LDJ", "LSTO",
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == (size_t)op::COUNT, "操作码名与操作码不一致");
+	return names[(int)f];
+}
+
+// 指令的文本形式：OP L A
+string insText(const Ins& ins) {
+	int L = ins.L, A = ins.A;
+	if (isOpr(ins.f)) {
+		L = 0;
+		A = oprCode(ins.f);
+	}
+	else if (isCmpJump(ins.f)) {
+		L = oprCode(jumpCmp(ins.f));
+	}
+	return string(opName(ins.f)) + " " + to_string(L) + " " + to_string(A);
+}
+
+// 由文本形式构造指令，无法识别返回false
+bool insFromText(const string& name, int L, int A, Ins& ins) {
+	ins.L = L;
+	ins.A = A;
+	if (name == "OPR") {
+		ins.L = 0;
+		ins.A = 0;
+		return oprFromCode(A, ins.f);
+	}
+	if (name == "JPC" && L != 0) {
+		op cmp;
+		if (!oprFromCode(L, cmp) || !isCmp(cmp)) return false;
+		ins.f = cmpJump(cmp);
+		ins.L = 0;
+		return true;
+	}
+	static const op plain[] = { op::LIT, op::LOD, op::STO, op::CAL, op::INT, op::JMP, op::JPC, op::RED, op::WRT,
+		op::LLOS, op::LDOS, op::LLO, op::LDO, op::LLJ, op::LDJ, op::LSTO };
+	for (op f : plain) {
+		if (name == opName(f)) {
+			ins.f = f;
+			return true;
+		}
+	}
+	return false;
+}
 
-//ջʽ¼,Ƕײʾdisplay
+// 检查超级指令s之后的各条指令（tail[0..superLen(s)-2]）是否符合其序列
+bool superTail(op s, const Ins* tail) {
+	bool lit = tail[0].f == op::LIT;
+	bool lod = tail[0].f == op::LOD;
+	switch (s) {
+	case op::LLOS: return lit && isBinary(tail[1].f) && tail[2].f == op::STO && tail[2].L != -1;
+	case op::LDOS: return lod && isBinary(tail[1].f) && tail[2].f == op::STO && tail[2].L != -1;
+	case op::LLO: return lit && isBinary(tail[1].f);
+	case op::LDO: return lod && isBinary(tail[1].f);
+	case op::LLJ: return lit && isCmpJump(tail[1].f);
+	case op::LDJ: return lod && isCmpJump(tail[1].f);
+	case op::LSTO: return tail[0].f == op::STO && tail[0].L != -1;
+	default: return false;
+	}
+}
+
+void (*onFatal)() = nullptr;//运行时致命错误终止前调用（写出环形跟踪缓冲区）
+
+//栈式活动记录,采用嵌套层次显示表display
 class Activation {
-	/*activation record ṹ
-	*0 :̬DL
-	 1 صַRA
-	 2 :ȫdisplayָʾֱ¼displayλ
-	 ID+
-	 β name+value
-	  name+value
-	 ֲdisplay
-	 ʱԪ
+	/*activation record 结构（固定4个单元的头部）
+	*0 :动态链接DL：调用者活动记录基址
+	 1 ：返回地址RA
+	 2 :调用前被覆盖的display项，返回时恢复
+	 3 :ID个数：参数+变量个数
+	 形参区 value
+	 变量区 value
+	 临时单元
+	调用只写头部和ID区并移动栈顶，返回只恢复一项display和栈顶，均与栈深度、嵌套层数无关
 	*/
-	/*display ṹ
-	в㵽δŸ¼ַ
+	/*display 结构
+	display[层] 为该层当前活动记录基址
+	调用时只保存并覆盖被调过程所在层的一项，外层各项即为调用者的display
 	*/
 public:
-	string name = "";//ǰ
-	int layer = 0;//ǰ
-	int define_layer = 0;//
-	int top = 0;//ջָ
-	int base = 0;//ջָ
-	vector<string> stack;//ջ
+	string name = "";//当前过程名
+	int layer = 0;//当前层
+	int define_layer = 0;//定义层
+	int top = 0;//栈顶指针
+	int base = 0;//栈底指针
+	vector<int> stack;//数据栈，只存整数，初始化时按stack_size一次分配
+	vector<pair<int, const ProcInfo*>> frames;//各活动记录基址及其过程信息，用于打印栈时给ID区标注名字
+	vector<int> display;//各层当前活动记录基址
 	Activation() {}
 
-	void init(SymbolTable& symTable) {
-		stack.clear();
+	// maxStack为主程序操作数栈最大深度（加载时校验得出）
+	void init(const ProcInfo& mainProc, int maxLevel, int maxStack) {
+		stack.assign(stack_size, 0);
+		frames.clear();
+		display.assign(maxLevel + 1, 0);
 		top = 0;
 		base = 0;
 		layer = 0;
 		define_layer = 0;
-		symTable.current_layer_ = symTable.first_layer_;
-		SymLayer* cur_layer = symTable.current_layer_;
-		int id_num = cur_layer->var_offset_;
-		int param_num = cur_layer->param_count_;
-		push("0");//̬DL
-		push("0");//صַRA
-		push("0");//ȫdisplay
-		push(to_string(id_num));//Id
-
-		//β
-		Symbol* sym = cur_layer->sym_head_;
-		while (sym != nullptr) {
-			if (sym->getType() == SYMBOLTYPE::PARAM) {
-				push(sym->getName()+":0");
-			}
-			sym = sym->getNext();
-		}
-
-		//
-		sym = cur_layer->sym_head_;
-		while (sym != nullptr) {
-			if (sym->getType() == SYMBOLTYPE::VAR) {
-				push(sym->getName()+":0");
-			}
-			sym = sym->getNext();
-		}
-		push("0");//ֲdisplay
+		name = mainProc.name;
+		frames.push_back({ 0, &mainProc });
+		reserve(4 + mainProc.id_count + maxStack);
+		stack[0] = 0;//动态链接DL
+		stack[1] = 0;//返回地址RA
+		stack[2] = 0;
+		stack[3] = mainProc.id_count;//Id个数
+		top = 4 + mainProc.id_count;//形参和变量已清零
 	}
 
-	void newSapce(int count) {
-		for (int i = 0; i < count; i++) {
-			stack.push_back("0");
-		}
-	}
-	void deleteSpace(int count ,int place = -1) {
-		if (place == -1) {
-			for (int i = 0; i < count; i++) {
-				stack.pop_back();
-			}
-		}
-		else {
-			for (int i = 0; i < count; i++) {
-				stack.erase(stack.begin() + place);
-			}
+	// 栈中还需要n个单元，不足时报告栈溢出并终止
+	void reserve(int n) {
+		if (top + n > (int)stack.size()) {
+			runtimeError("栈溢出（栈大小 " + to_string(stack.size()) + "，可用 -stack=<单元数> 调整）");
+			if (onFatal) onFatal();
+			exit(1);
 		}
 	}
 
-	string get(int offset) {
-		string val = stack.at(base + offset);
-		return val;
+	int get(int offset) {
+		return stack[base + offset];
 	}
-	void set(int offset, const string& val) {
-		stack.at(base + offset) = val;
+	void set(int offset, int val) {
+		stack[base + offset] = val;
 	}
 
-	void push(const string& val) {
-		if (top >= stack.size()) {
-			newSapce(1);
-		}
-		stack.at(top) = val;
-		top++;
+	// 建立活动记录时已按校验得出的最大深度预留空间，校验也保证不会弹空，压栈、弹栈均不检查
+	void push(int val) {
+		stack[top++] = val;
 	}
-	string pop() {
-		if (top > 0) {
-			string val = stack.at(top - 1);
-			top--;
-			return val;
-		}
-		cerr << "ջգ޷" << endl;
+	int pop() {
+		return stack[--top];
 	}
 
-	string* getId(int L, int A) {
-		int a1 = base + 4 + stoi(get(3)); 
-		int baseL = stoi(stack.at(a1 +  L));
-		return & stack[baseL + A];
+	// L层活动记录的第A个单元：两次整数读取
+	int* getId(int L, int A) {
+		return &stack[display[L] + A];
 	}
 	int getIdVal(int L, int A) {
-		//ͨdisplayȡֵ
-		int a1 = base + 4 + stoi(get(3));
-		int baseL = stoi(stack.at(a1 +  L));
-		string s = stack.at(baseL + A);
-		int pos = s.find(":");
-		string val_str = s.substr(pos + 1);
-		return stoi(val_str);
+		//通过display获取变量值
+		return *getId(L, A);
 	}
 
-	void newAc(SymLayer* symlayer) {
+	// 建立过程proc的活动记录，ret为返回地址，maxStack为其操作数栈最大深度
+	void newAc(const ProcInfo& proc, int ret, int maxStack) {
 		int newbase = top;
+		int id_num = proc.id_count;
+		reserve(4 + id_num + maxStack);
+
+		name = proc.name;
+		define_layer = proc.level;
+		frames.push_back({ newbase, &proc });
+
+		int* ar = &stack[newbase];
+		ar[0] = base;//动态链接DL
+		ar[1] = ret;//返回地址RA
+		ar[2] = display[proc.level];
+		ar[3] = id_num;//Id个数
+		fill(ar + 4, ar + 4 + id_num, 0);//形参和变量
+		display[proc.level] = newbase;
 
-		Symbol* proc_sym = symlayer->outer_->findInLayer(symlayer->getLayerName());
-		int id_num = symlayer->var_offset_; 
-		int param_num = symlayer->param_count_;
-		name = symlayer->getLayerName();
-		define_layer = symlayer->getLevel();
-		File << "\nnewAc:" << name  << endl;
-		push(to_string(base));//̬DL
-		push("0");//صַRA
-
-		int global_display_pos = base + 4 + stoi(get(3));
-		push(to_string(global_display_pos));//ȫdisplay
-		push(to_string(id_num));//Id
-		//β
-		Symbol* sym = symlayer->sym_head_;
-		while (sym != nullptr) {
-			if (sym->getType() == SYMBOLTYPE::PARAM) {
-				push(sym->getName() + ":0");
-			}
-			sym = sym->getNext();
-		}
-		//
-		sym = symlayer->sym_head_;
-		while (sym != nullptr) {
-			if (sym->getType() == SYMBOLTYPE::VAR) {
-				push(sym->getName() + ":0");
-			}
-			sym = sym->getNext();
-		}
-
-		//ֲdisplay
-		int proc_level = symlayer->getLevel();
-		for (int i = 0; i <= proc_level - 1; i++) {
-			push(stack.at(global_display_pos+i)); 
-			
-		}
-		push(to_string(newbase));//ǰdisplay
-	
 		base = newbase;
+		top = newbase + 4 + id_num;
 		layer++;
+	}
+	// 撤销当前活动记录，返回其返回地址
+	int returnAc() {
+		int ret = stack[base + 1];
+		display[define_layer] = stack[base + 2];
+		//删除当前活动记录，恢复上一个活动记录
+		top = base;
+		base = stack[base];//动态链接DL
+		layer--;
+		frames.pop_back();
+		define_layer = frames.back().second->level;
+		name = frames.back().second->name;
+		return ret;
+	}
+
+	// 跟踪输出：进入、返回活动记录
+	void traceCall() {
+		File << "\nnewAc:" << name << endl;
 		if (key) {
-			cout << "\n»¼ǰ㼶" << layer << endl;
+			cout << "\n进入新活动记录，当前层级：" << layer << endl;
 			cout << "base=" << base << ",top=" << top << endl;
 		}
 	}
-	void returnAc() {
-		//ָһ¼
-		int return_base = stoi(get(0));//̬DL
-		int return_RA = stoi(get(1));//صַRA
-		//ɾǰ¼
-		top = base;
-		base = return_base;
-		layer--;
-		//صַݲɽPC޸
+	void traceReturn() {
 		if (key) {
-			cout << "\nһ¼ǰ㼶" << layer << endl;
+			cout << "\n返回上一个活动记录，当前层级：" << layer << endl;
 		}
 		File << "\nback " << layer << endl;
 	}
 
+	// 栈单元的文本形式，ID区为 name:value
+	string slotText(int i, int& frame) {
+		while (frame > 0 && frames[frame].first > i) frame--;
+		const ProcInfo* proc = frames[frame].second;
+		int k = i - frames[frame].first - 4;
+		if (k >= 0 && k < proc->id_count) {
+			return proc->ids[k] + ":" + to_string(stack[i]);
+		}
+		return to_string(stack[i]);
+	}
+
 	void printStack() {
-		//ջ״ӡ
-		if (key) cout << "\nǰ¼ջݣ" << endl;
+		//从栈顶到底打印
+		if (key) cout << "\n当前活动记录栈内容：" << endl;
 
+		int frame = frames.size() - 1;
 		for(int i = top - 1; i >= 0; i--) {
-			if(key)cout << "[" << i << "]: " << stack.at(i) << endl;
-			File << "[" << i << "]: " << stack.at(i) << endl;
+			string s = slotText(i, frame);
+			if(key)cout << "[" << i << "]: " << s << endl;
+			File << "[" << i << "]: " << s << endl;
 		}
 	}
 };
 
+/*
+分层执行（-vm=tier）的本机层，由JIT.h实现
+解释器统计各过程的调用次数和各循环回边的执行次数，超过阈值时交给本机层：
+过程在下一次调用时整体改用本机代码；正在执行的循环在回边处原地转入本机代码（OSR），直到该活动记录返回
+call/enter 返回 0 程序已结束，1 运行时错误（已报告），2 过程已返回，解释器从返回地址继续
+*/
+class NativeTier {
+public:
+	virtual ~NativeTier() {}
+	// 首次升级时翻译，失败时返回false（只报告一次），之后一直用解释器
+	virtual bool ready() = 0;
+	// 调用下标为proc的过程，args为解释器收集的实参（偏移，值）
+	virtual int call(int proc, Activation& Ac, const vector<pair<int, int>>& args) = 0;
+	// 当前活动记录从循环头pc起改用本机代码执行
+	virtual int enter(int pc, Activation& Ac) = 0;
+	// 统计报告中的一行说明（代码大小、翻译用时）
+	virtual string describe() const = 0;
+};
+
+// 计算二元运算（算术、关系），除零、除法溢出（INT_MIN / -1）或非二元运算返回false
+// 加减乘按二进制补码回绕（经unsigned计算），常量折叠与运行时结果一致
+bool evalOpr(op f, int a, int b, int& result) {
+	switch (f) {
+	case op::ADD: result = (int)((unsigned)a + (unsigned)b); return true;
+	case op::SUB: result = (int)((unsigned)a - (unsigned)b); return true;
+	case op::MUL: result = (int)((unsigned)a * (unsigned)b); return true;
+	case op::DIV:
+		if (b == 0 || (a == INT_MIN && b == -1)) return false;
+		result = a / b;
+		return true;
+	case op::EQ: result = a == b ? 1 : 0; return true;
+	case op::NE: result = a != b ? 1 : 0; return true;
+	case op::LT: result = a < b ? 1 : 0; return true;
+	case op::LE: result = a <= b ? 1 : 0; return true;
+	case op::GT: result = a > b ? 1 : 0; return true;
+	case op::GE: result = a >= b ? 1 : 0; return true;
+	default: return false;
+	}
+}
+
 class Pcode
 {
 private:
-	vector<int> jumpStack; // תַջ
+	vector<int> jumpStack; // 跳转地址栈（辅助回填）
+	int lastTarget = -1;   // 最近登记的跳转目标地址，常量折叠不能删除作为跳转目标的指令
 
 public:
-	int PC = 0; // ¼ָ
-	vector<label> labels; // ǩ
-	vector<Ins> code;     // Pcode洢
+	int PC = 0; // 程序计数器（记录指令总数）
+	vector<label> labels; // 标签表
+	vector<Ins> code;     // Pcode代码存储区
+	vector<SrcPos> lines; // 每条指令对应的源码位置
+	SrcPos pos;           // 当前源码位置，由语法分析器更新
+	int folded = 0;       // 常量折叠消除的指令条数
+	long long steps = 0;  // 解释执行的指令条数
+	vector<const ProcInfo*> entryProc;     // 入口地址 -> 过程，由verify建立
+	vector<int> maxStack;                   // 各过程操作数栈最大深度，由verify计算
+	vector<int> procOf;                     // 各指令所属过程下标，由verify计算（不可达指令为-1）
+	vector<int> stackDepth;                 // 各指令执行前操作数栈深度，由verify计算
+	const DebugInfo* verifiedFor = nullptr; // 最近一次通过校验时使用的调试信息
+	chrono::steady_clock::time_point startTime; // 解释执行开始时间
+	NativeTier* tier = nullptr;             // 分层执行的本机层，为空时只解释执行
 
-	void emit(string op,int L,int A,int count){//ǰcount
+	// 输出执行统计（指令条数、用时、每秒指令数）
+	void printStats() {
+		if (!stats_mode) return;
+		double sec = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+		cout << "执行指令 " << steps << " 条，用时 " << sec << " 秒，"
+			<< (sec > 0 ? (long long)(steps / sec) : 0) << " 条/秒" << endl;
+	}
+
+	void setPos(int row, int column) {
+		pos.row = row;
+		pos.column = column;
+	}
+
+	void emit(op f,int L,int A,int count){//插入前count个
 		Ins instruction;
-		instruction.op = op;
+		instruction.f = f;
 		instruction.L = L;
 		instruction.A = A;
 		if (count < 0 || count > code.size()) {
-			cerr << "λԽ: " << PC-count << endl;
+			cerr << "插入位置越界: " << PC-count << endl;
 			return;
 		}
 		code.insert(code.begin() + (PC - count), instruction);
-		PC++; // 
+		lines.insert(lines.begin() + (PC - count), pos);
+		PC++; // 程序计数器自增
 	}
-	void emit(string op, int L, int A) {
+	void emit(op f, int L, int A) {
 		Ins instruction;
-		instruction.op = op;
+		instruction.f = f;
 		instruction.L = L;
 		instruction.A = A;
 		code.push_back(instruction);
-		PC++; // 
+		lines.push_back(pos);
+		PC++; // 程序计数器自增
+	}
+
+	// 登记跳转目标地址（回填的目标都在当前PC）
+	void markTarget(int addr) {
+		if (addr > lastTarget) lastTarget = addr;
+	}
+
+	// 常量折叠：栈顶两条指令均为LIT时，直接计算二元运算结果，否则生成OPR
+	void emitOpr(op f) {
+		int n = code.size();
+		int result = 0;
+		if (fold_mode && n >= 2 && n - 1 > lastTarget && code[n - 1].f == op::LIT && code[n - 2].f == op::LIT
+			&& evalOpr(f, code[n - 2].A, code[n - 1].A, result)) {
+			code[n - 2].A = result;
+			code.pop_back();
+			lines.pop_back();
+			PC--;
+			folded += 2;//省去一条LIT和一条OPR
+			return;
+		}
+		if (fold_mode && f == op::ODD && n >= 1 && code[n - 1].f == op::LIT) {
+			code[n - 1].A = code[n - 1].A % 2;
+			folded += 1;
+			return;
+		}
+		emit(f, 0, 0);
+	}
+
+	// 生成条件跳转并登记标签id；条件已折叠为常量时，真则不生成跳转，假则改为JMP
+	void emitCondJump(string id) {
+		//条件表达式总以OPR结尾，末尾是LIT说明整个条件已被折叠
+		if (fold_mode && !code.empty() && code.back().f == op::LIT) {
+			int cond = code.back().A;
+			code.pop_back();
+			lines.pop_back();
+			PC--;
+			if (cond != 0) {
+				newLabel(id, -1);//无指令需要回填
+				folded += 2;
+			}
+			else {
+				newLabel(id, PC);
+				emit(op::JMP, 0, 0);//待回填
+				folded += 1;
+			}
+			return;
+		}
+		newLabel(id, PC);
+		emit(op::JPC, 0, 0);//待回填
 	}
 
 	void addJump() {
 		jumpStack.push_back(PC);
 	}
 	void fillJump(int A) {
+		markTarget(A);
 		if (jumpStack.empty()) {
-			cerr << "תַջΪգ޷" << endl;
+			cerr << "跳转地址栈为空，无法回填" << endl;
 			return;
 		}
 		int addr = jumpStack.back();
 		jumpStack.pop_back();
 		if (addr < 0 || addr >= code.size()) {
-			cerr << "ַԽ: " << addr << endl;
+			cerr << "回填地址越界: " << addr << endl;
 			return;
 		}
 		code[addr].A = A;
@@ -288,302 +544,482 @@ public:
 		l.id = id;
 		l.place = place;
 		labels.push_back(l);
-		// ظñǩڱǩеһԪص
+		// 返回该标签在标签表中的索引（最后一个元素的索引）
 		return labels.size() - 1;
 	}
 
-	// ָƫAֵַԽжϣ
+	// 根据指令偏移量回填A值（修正地址越界判断）
 	void backPatch(int offset, int A) {
+		markTarget(A);
 		if (offset < 0 || offset >= code.size()) { 
-			cerr << "ַԽ: " << offset << endl;
+			cerr << "回填地址越界: " << offset << endl;
 			return;
 		}
 		code[offset].A = A;
 	}
-	// ݱǩidַӺǰҵһƥıǩ
+	// 根据标签id回填地址（从后向前查找第一个匹配的标签）
 	void backPatch(string id, int A) {
+		markTarget(A);
 		vector<label>::reverse_iterator it;
 		for (it = labels.rbegin(); it != labels.rend(); ++it) {
 			if (it->id == id) {
-				// ҵƥǩӦַָ
-				code[it->place].A = A;
-				//ɾǩ
-				labels.erase((it + 1).base()); // תΪ
+				// 找到匹配标签，回填其对应的指令地址（条件折叠后可能没有跳转指令）
+				if (it->place >= 0) code[it->place].A = A;
+				//删除标签
+				labels.erase((it + 1).base()); // 反向迭代器转换为正向迭代器
 				
 				return;
 			}
 		}
-		// δҵǩʱʾ
-		cerr << "δҵǩ: " << id << "ʧ" << endl;
+		// 未找到标签时给出提示
+		cerr << "未找到标签: " << id << "，回填失败" << endl;
+	}
+
+	// 删除keep为false的指令并重定位JMP/JPC/CAL目标
+	// 返回旧地址到新地址的映射，被删除的指令映射到其后第一条保留的指令
+	vector<int> compact(const vector<bool>& keep) {
+		int n = code.size();
+		vector<int> newAddr(n + 1);
+		int next = 0;
+		for (int i = 0; i < n; i++) {
+			newAddr[i] = next;
+			if (keep[i]) next++;
+		}
+		newAddr[n] = next;
+
+		vector<Ins> newCode;
+		vector<SrcPos> newLines;
+		newCode.reserve(next);
+		newLines.reserve(next);
+		for (int i = 0; i < n; i++) {
+			if (!keep[i]) continue;
+			Ins ins = code[i];
+			if (hasTarget(ins.f) && ins.A >= 0 && ins.A <= n) {
+				ins.A = newAddr[ins.A];
+			}
+			newCode.push_back(ins);
+			newLines.push_back(i < (int)lines.size() ? lines[i] : SrcPos());
+		}
+		code.swap(newCode);
+		lines.swap(newLines);
+		PC = code.size();
+		return newAddr;
 	}
 
 	void printCode() {
 		if (key) {
-			cout << "\nɵPcode£\n" << endl;
+			cout << "\n生成的Pcode代码如下：\n" << endl;
 			for (int i = 0; i < code.size(); i++) {
-				cout << i << ": " << code[i].op << " " << code[i].L << " " << code[i].A << endl;
+				cout << i << ": " << insText(code[i]) << endl;
 			}
 		}
 		for (int i = 0; i < code.size(); i++) {
-			File<< i << ": " << code[i].op << " " << code[i].L << " " << code[i].A << endl;
+			File<< i << ": " << insText(code[i]) << endl;
 		}
 	}
-	Ins& getInstruction(int index) { // Ins&˽нṹڲأ
+	Ins& getInstruction(int index) { // 改用Ins&（私有结构体在类内部可正常返回）
 		if (index < 0 || index >= code.size()) {
-			throw runtime_error("ָԽ: " + to_string(index));
+			throw runtime_error("指令索引越界: " + to_string(index));
 		}
 		return code[index];
 	}
 
-	// ִPcode
+	// 解释执行Pcode（使用内存中的符号表）
 	void interpret(SymbolTable& symTable) {
-		int pc = 0;
-		vector<int> returnStack; // صַջ
-		Activation Ac; // ¼ջʽ
-		Ac.init(symTable); // ʼ¼ջ
-		vector<vector<int>> args; // »¼Ĳ洢
-
-		File.open("pcode_output.txt", ios::out);
-		if(!File.is_open()) {
-			cerr << "޷ļ" << endl;
-			return;
-		}
+		DebugInfo dbg;
+		dbg.build(symTable, lines);
+		if (!verify(dbg)) return;
+		interpret(dbg);
+	}
 
-		while (1) {
-			Ins instr = getInstruction(pc);
-			pc++;
-			string op = instr.op;
-			if(key)cout<<pc-1<<": " << op << " " << instr.L << " " << instr.A << endl;
-			File << pc - 1 << ": " << op << " " << instr.L << " " << instr.A << endl;
-			if(op == "LIT") {// ջ
-				int value = instr.A;
-				Ac.push(to_string(value));
-			}
-			else if (op == "LOD") {// /ջ
-				
-				int value = Ac.getIdVal(instr.L, instr.A + 4);
-				Ac.push(to_string(value));
+	// 解释执行Pcode（简易虚拟机），过程布局来自调试信息
+	// 只有开启跟踪时才输出每步执行轨迹：-trace 文本写入 pcode_output.txt，-trace=bin 二进制写入 pcode_trace.bin
+	void interpret(const DebugInfo& dbg) {
+		if (verifiedFor != &dbg && !verify(dbg)) return;
+		if (!output.open(out_file) || !input.open(in_file)) return;
+		if (trace_mode && trace_binary) {
+			vector<string> names;
+			vector<pair<int, int>> la;
+			for (const Ins& ins : code) {
+				istringstream in(insText(ins));
+				string name;
+				int L = 0, A = 0;
+				in >> name >> L >> A;
+				names.push_back(name);
+				la.push_back({ L, A });
 			}
-			else if (op == "STO") {// ջֵ/
-				int val = stoi(Ac.pop());
-				
-
-				if (instr.L == -1) {// »ı洢
-					vector<int> arg;
-					arg.push_back(instr.L);
-					arg.push_back(instr.A+4);
-					arg.push_back(val);
-					
-					args.insert(args.begin(), arg);
-				}
-				else {
-					string* s = Ac.getId(instr.L, instr.A + 4);
-					
-					int pos = s->find(":");
-					string name = s->substr(0, pos);
-					string val_str = s->substr(pos + 1);
-					val_str = to_string(val);
-					*s = name + string(":") + val_str;
-				
-				}
+			if (!btrace.open("pcode_trace.bin", names, la, dbg)) return;
+		}
+		else if (trace_mode && trace_ring == 0) {
+			File.open("pcode_output.txt", ios::out);
+			if(!File.is_open()) {
+				cerr << "无法打开输出文件" << endl;
+				return;
 			}
-			else if (op == "CAL") {// ̵
-				returnStack.push_back(pc);
-				pc = instr.A;
+		}
 
-				SymLayer* symlayer = symTable.findProcByEntry(pc);
-				
-				// ʼ»¼
-				Ac.newAc(symlayer);
-				
-				// ݲ
-				while (!args.empty()) {
-					vector<int> arg = args.back();
-					args.pop_back();
-					int L = arg[0];
-					L = Ac.define_layer;
-						
-					int offset = arg[1];
-					int val = arg[2];
-					string* s = Ac.getId(L, offset);
-					int pos = s->find(":");
-					string name = s->substr(0, pos);
-					string val_str = s->substr(pos + 1);
-					val_str = to_string(val);
-					*s = name + ":" + val_str;
-						
-
-					
-				}
+		if (trace_mode) traceStart(dbg);
 
+		steps = 0;
+		if (tier != nullptr) tierStart(dbg);
+		bool profiled = profile_mode && !trace_mode && tier == nullptr;
+		if (profiled) profile.start(code.size(), dbg.procs.size());
+		startTime = chrono::steady_clock::now();
+#ifdef PL0_THREADED
+		if (threaded_mode) {
+			if (trace_mode) run<true, true>(dbg);
+			else if (tier != nullptr) run<true, false, true>(dbg);
+			else if (profiled) run<true, false, false, true>(dbg);
+			else run<true, false>(dbg);
+		}
+		else
+#endif
+		if (trace_mode) run<false, true>(dbg);
+		else if (tier != nullptr) run<false, false, true>(dbg);
+		else if (profiled) run<false, false, false, true>(dbg);
+		else run<false, false>(dbg);
+		if (profiled) {//正常结束或运行时错误返回后写出
+			vector<string> text, opKey;
+			for (const Ins& ins : code) {
+				text.push_back(insText(ins));
+				opKey.push_back(opLabel(ins.f));
 			}
-			else if (op == "INT") {// 
-				Ac.newSapce(instr.A);
+			profile.write("pcode_profile.txt", "pcode_profile.folded", text, opKey, procOf, dbg);
+			profile.writeSource("pcode_profile_src.txt", profile_src.empty() ? "pascal.txt" : profile_src, procOf, dbg);
+		}
+		output.close();
+		input.close();
+		btrace.close();
+		dumpRing();//正常结束或运行时错误返回后写出
+	}
 
-			}
-			else if (op == "JMP") {// ת
-				pc = instr.A;
+	void printCodeFile(string file) {
+		fstream f;
+		f.open(file, ios::out);
+		if (!f.is_open()) {
+			cerr << file << " can't open" << endl;
+			exit(1);
+		}
+		for (int i = 0; i < code.size(); i++) {
+			f<< i << ": " << insText(code[i]) << endl;
+		}
+		cout << "pcode已输出到文件," << file << endl;
+		f.close();
+	}
+
+	// 输出调试信息旁路文件（过程表、活动记录布局、行号映射）
+	void printDebugFile(SymbolTable& symTable, string file) {
+		DebugInfo dbg;
+		dbg.build(symTable, lines);
+		if (!dbg.save(file)) {
+			exit(1);
+		}
+		cout << "调试信息已输出到文件," << file << endl;
+	}
+
+	/*二进制映像文件格式（小端），pl0vm 直接加载执行
+	头部：magic "PL0I" | version(u32) | 节个数(u32) | 校验和(u32，头部和节表之后全部字节的FNV-1a)
+	节表：每节 类型(u32) 偏移(u32，从文件头算起) 长度(u32)
+	节：CODE 指令数组（每条8字节，与Ins内存布局相同）
+	    PROC 过程表（同pcode.dbg的布局部分：入口、层、外层过程、形参个数、ID个数）
+	    DEBUG 过程名、ID名、行号映射（可选，没有时跟踪输出中过程名为 proc@入口地址）
+	常量都是LIT指令的32位立即数，不需要单独的常量池
+	加载时检查校验和，再由verify检查跳转目标、层次、变量偏移和栈深度
+	*/
+	static const uint32_t IMAGE_VERSION = 2;
+	enum ImageSection : uint32_t { SEC_CODE = 1, SEC_PROC = 2, SEC_DEBUG = 3 };
+
+	static uint32_t checksum(const char* p, size_t n) {
+		uint32_t h = 2166136261u;
+		for (size_t i = 0; i < n; i++) {
+			h ^= (uint8_t)p[i];
+			h *= 16777619u;
+		}
+		return h;
+	}
 
+	// 输出二进制映像，withDebug为false时不含调试节
+	void printImageFile(SymbolTable& symTable, string file, bool withDebug = true) {
+		DebugInfo dbg;
+		dbg.build(symTable, lines);
+		vector<pair<uint32_t, string>> sections;
+		sections.push_back({ SEC_CODE, string((const char*)code.data(), code.size() * sizeof(Ins)) });
+		sections.push_back({ SEC_PROC, "" });
+		dbg.writeLayout(sections.back().second);
+		if (withDebug) {
+			sections.push_back({ SEC_DEBUG, "" });
+			dbg.writeNames(sections.back().second);
+		}
+
+		size_t head = 16 + sections.size() * 12;
+		string body;
+		vector<uint32_t> table;
+		for (auto& sec : sections) {
+			while (body.size() % 8 != 0) body.push_back('\0');//各节8字节对齐
+			table.push_back(sec.first);
+			table.push_back((uint32_t)(head + body.size()));
+			table.push_back((uint32_t)sec.second.size());
+			body += sec.second;
+		}
+		string rest((const char*)table.data(), table.size() * 4);
+		rest += body;
+		uint32_t header[3] = { IMAGE_VERSION, (uint32_t)sections.size(), 0 };
+		string buf("PL0I", 4);
+		buf.append((const char*)header, sizeof(header));
+		buf += rest;
+		header[2] = checksum(buf.data() + 16, buf.size() - 16);
+		memcpy(&buf[4], header, sizeof(header));
+
+		ofstream ofs(file, ios::out | ios::binary);
+		if (!ofs.is_open()) {
+			cerr << file << " can't open" << endl;
+			exit(1);
+		}
+		ofs.write(buf.data(), buf.size());
+		cout << "二进制映像已输出到文件," << file << endl;
+	}
+
+	// 一次读入二进制映像，指令数组直接复制；格式错误、校验和不符或校验失败时拒绝加载
+	bool loadImage(string file, DebugInfo& dbg) {
+		ifstream ifs(file, ios::in | ios::binary | ios::ate);
+		if (!ifs.is_open()) {
+			cerr << "无法打开映像文件: " << file << endl;
+			return false;
+		}
+		streamsize size = ifs.tellg();
+		ifs.seekg(0);
+		string buf(size, '\0');
+		if (!ifs.read(&buf[0], size)) {
+			cerr << "读取映像文件失败: " << file << endl;
+			return false;
+		}
+
+		auto fail = [&](const string& why) {
+			cerr << "映像文件 " << file << " 无效：" << why << endl;
+			code.clear();
+			return false;
+			};
+		uint32_t header[3] = { 0, 0, 0 };
+		if (buf.size() < 16 || buf.compare(0, 4, "PL0I") != 0) return fail("不是PL/0映像（magic 不符）");
+		memcpy(header, buf.data() + 4, sizeof(header));
+		if (header[0] != IMAGE_VERSION) return fail("不支持的版本 " + to_string(header[0]));
+		if (header[1] > 64 || buf.size() < 16 + (size_t)header[1] * 12) return fail("节表不完整");
+		if (checksum(buf.data() + 16, buf.size() - 16) != header[2]) return fail("校验和不符");
+
+		const char* sec[4] = { nullptr, nullptr, nullptr, nullptr };
+		size_t secSize[4] = { 0, 0, 0, 0 };
+		for (uint32_t i = 0; i < header[1]; i++) {
+			uint32_t t[3];
+			memcpy(t, buf.data() + 16 + i * 12, sizeof(t));
+			if ((size_t)t[1] + t[2] > buf.size()) return fail("节超出文件范围");
+			if (t[0] >= 1 && t[0] <= 3) {
+				sec[t[0]] = buf.data() + t[1];
+				secSize[t[0]] = t[2];
 			}
-			else if (op == "JPC") {// ת
-				int cond = stoi(Ac.pop());
-				if (cond == 0) {
-					pc = instr.A;
-				}
+		}
+		if (sec[SEC_CODE] == nullptr || sec[SEC_PROC] == nullptr) return fail("缺少代码节或过程表节");
+		if (secSize[SEC_CODE] % sizeof(Ins) != 0) return fail("代码节长度不是指令长度的整数倍");
+
+		code.resize(secSize[SEC_CODE] / sizeof(Ins));
+		memcpy(code.data(), sec[SEC_CODE], secSize[SEC_CODE]);
+		string part(sec[SEC_PROC], secSize[SEC_PROC]);
+		size_t pos = 0;
+		if (!dbg.readLayout(part, pos)) return fail("过程表格式错误");
+		if (sec[SEC_DEBUG] != nullptr) {
+			part.assign(sec[SEC_DEBUG], secSize[SEC_DEBUG]);
+			pos = 0;
+			if (!dbg.readNames(part, pos)) return fail("调试节格式错误");
+		}
+		PC = static_cast<int>(code.size());
+		lines = dbg.lines;
+		lines.resize(code.size());
+		return verify(dbg);
+	}
 
+	/*
+	加载时校验，通过后解释器主循环不再检查指令地址和过程入口
+	每个过程从入口出发沿控制流（不进入CAL）遍历，要求：
+	操作码合法；跳转目标在代码范围内，CAL目标是过程入口；控制流不会越过代码末尾；
+	一条指令只属于一个过程；变量的层在0和所在过程层之间，偏移在该层过程的ID区内；
+	每条指令执行前的操作数栈深度在所有路径上相同且不会弹空；
+	STO -1 A 暂存的实参在所有路径上相同，CAL时偏移都在被调过程的形参区内，RET时没有未传入的实参
+	同时得出各过程操作数栈的最大深度，调用时按此一次预留，压栈、弹栈不再检查
+	各指令所属过程和执行前栈深度留在procOf、stackDepth中，供JIT和C后端使用
+	*/
+	bool verify(const DebugInfo& dbg) {
+		int n = code.size();
+		verifiedFor = nullptr;
+		entryProc.assign(n, nullptr);
+		for (const ProcInfo& p : dbg.procs) {
+			if (p.entry < 0 || p.entry >= n) {
+				cerr << "校验失败：过程 " << p.name << " 的入口地址 " << p.entry << " 超出代码范围" << endl;
+				return false;
 			}
-			else if (op == "OPR") {// /
-				switch (instr.A)
-				{
-					case 0:// ̷
-					{
-						if (returnStack.empty()) {
-							for (int i : write_result) {
-								cout << ": " << i << endl;
-								//File << ": " << i << endl;
-							}
-							cout << "" << endl;
-							return;
-						}
-						pc = returnStack.back();
-						returnStack.pop_back();
+			entryProc[p.entry] = &p;
+		}
 
-						Ac.returnAc();
-						break;
-					}
-					case 1:// ȡ
-					{
-						int val = stoi(Ac.pop());
-						Ac.push(to_string(-val));
-						break;
-					}
-					case 2:// ӷ
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a + b));
-						break;
-					}
-					case 3:// 
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a - b));
-						break;
-					}
-					case 4:// ˷
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a * b));
-						break;
-					}
-					case 5:// 
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						if (b == 0) {
-							cerr << "ʱ󣺳" << endl;
-							return;
-						}
-						Ac.push(to_string(a / b));
-						break;
-					}
-					case 6:// żж
-					{
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a % 2));
-						break;
-					}
-					case 7:// 
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a == b ? 1 : 0));
-						break;
-					}
-					case 8:// 
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a != b ? 1 : 0));
-						break;
-					}
-					case 9:// С
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a < b ? 1 : 0));
-						break;
-					}
-					case 10:// Сڵ
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a <= b ? 1 : 0));
-						break;
-					}
-					case 11:// 
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a > b ? 1 : 0));
+		maxStack.assign(dbg.procs.size(), 0);
+		vector<int>& owner = procOf;
+		vector<int>& depth = stackDepth;
+		vector<int> staged(n, 0); // 各指令执行前已暂存实参的最大偏移+1，0为没有
+		owner.assign(n, -1);
+		depth.assign(n, -1);
+		string why;
+		int at = -1;
+		for (int pi = 0; pi < (int)dbg.procs.size() && why.empty(); pi++) {
+			const ProcInfo& proc = dbg.procs[pi];
+			vector<int> work;
+			auto flow = [&](int from, int t, int d, int a) {
+				if (t < 0 || t >= n) {
+					why = t == n ? "控制流越过代码末尾" : "跳转目标 " + to_string(t) + " 超出代码范围";
+					at = from;
+				}
+				else if (owner[t] == -1) {
+					owner[t] = pi;
+					depth[t] = d;
+					staged[t] = a;
+					work.push_back(t);
+				}
+				else if (owner[t] != pi) {
+					why = "与过程 " + dbg.procs[owner[t]].name + " 共用指令 " + to_string(t);
+					at = from;
+				}
+				else if (depth[t] != d) {
+					why = "到达 " + to_string(t) + " 时栈深度不一致（" + to_string(depth[t]) + " 与 " + to_string(d) + "）";
+					at = from;
+				}
+				else if (staged[t] != a) {
+					why = "到达 " + to_string(t) + " 时暂存的实参不一致";
+					at = from;
+				}
+				};
+			// 变量(L, A)：L层为所在过程或其外层过程
+			auto var = [&](const Ins& v) {
+				if (v.L == -1 && v.f == op::STO) return v.A >= 0;//暂存的实参，偏移在CAL处按被调过程的形参个数检查
+				if (v.L < 0 || v.L > proc.level) return false;
+				int k = pi;
+				while (k >= 0 && dbg.procs[k].level > v.L) k = dbg.procs[k].parent;
+				return k >= 0 && dbg.procs[k].level == v.L && v.A >= 0 && v.A < dbg.procs[k].id_count;
+				};
+
+			flow(proc.entry, proc.entry, 0, 0);
+			while (!work.empty() && why.empty()) {
+				int i = work.back();
+				work.pop_back();
+				Ins ins = code[i];
+				int d = depth[i];
+				int a = staged[i];
+				at = i;
+				if ((uint8_t)ins.f >= (uint8_t)op::COUNT) {
+					why = "无法识别的操作码";
+					break;
+				}
+				// 超级指令按其首条指令检查，之后的操作数指令仍在原处，作为后继逐条检查
+				if (isSuper(ins.f)) {
+					if (i + superLen(ins.f) > n || !superTail(ins.f, &code[i + 1])) {
+						why = "超级指令之后的指令序列不完整";
 						break;
 					}
-					case 12:// ڵ
-					{
-						int b = stoi(Ac.pop());
-						int a = stoi(Ac.pop());
-						Ac.push(to_string(a >= b ? 1 : 0));
-						break;
+					ins.f = superHead(ins.f);
+				}
+				// 需要的栈深度、执行后的栈深度
+				int need = 0, after = d, staging = a;
+				switch (ins.f) {
+				case op::LIT: case op::RED:
+					after = d + 1;
+					break;
+				case op::LOD:
+					if (!var(ins)) why = "变量层次或偏移无效";
+					after = d + 1;
+					break;
+				case op::STO:
+					if (!var(ins)) why = "变量层次或偏移无效";
+					if (ins.L == -1) staging = max(a, ins.A + 1);
+					need = 1;
+					after = d - 1;
+					break;
+				case op::WRT: case op::JPC:
+					need = 1;
+					after = d - 1;
+					break;
+				case op::NEG: case op::ODD:
+					need = 1;
+					break;
+				case op::DUP:
+					need = 1;
+					after = d + 1;
+					break;
+				case op::CAL:
+					if (ins.A < 0 || ins.A >= n || entryProc[ins.A] == nullptr) why = "调用目标 " + to_string(ins.A) + " 不是过程入口";
+					else if (a > entryProc[ins.A]->param_count) {
+						why = "实参偏移 " + to_string(a - 1) + " 超出过程 " + entryProc[ins.A]->name + " 的形参个数 " + to_string(entryProc[ins.A]->param_count);
 					}
+					staging = 0;
+					break;
+				case op::RET:
+					if (a != 0) why = "返回时仍有未传入的实参";
+					break;
 				default:
+					if (isBinary(ins.f) || isCmpJump(ins.f)) {
+						need = 2;
+						after = d - (isCmpJump(ins.f) ? 2 : 1);
+					}
 					break;
 				}
+				if (!why.empty()) break;
+				if (d < need) {
+					why = "操作数栈弹空（深度 " + to_string(d) + "，需要 " + to_string(need) + "）";
+					break;
+				}
+				maxStack[pi] = max(maxStack[pi], after);
+				// 后继
+				if (ins.f == op::RET) continue;
+				if (ins.f == op::JMP) {
+					flow(i, ins.A, after, staging);
+					continue;
+				}
+				if (ins.f == op::JPC || isCmpJump(ins.f)) flow(i, ins.A, after, staging);
+				if (why.empty()) flow(i, i + 1, after, staging);
 			}
-			else if (op == "RED") {// ֵջ
-				string input;
-				cout << "ȴ룺" << endl;
-				cin >> input;
-				Ac.push(input);
-
-
-			}
-			else if (op == "WRT") {// ջֵ
-				write_result.push_back(stoi(Ac.pop()));
-			}
-
-			else {
-				cerr << "δ֪: " << op << endl;
-				break;
-			}
-			
-			Ac.printStack();
-			
 		}
+		if (!why.empty()) {
+			cerr << "校验失败：";
+			if (at >= 0 && at < n) cerr << "地址 " << at << ": " << insText(code[at]) << "：";
+			cerr << why << endl;
+			return false;
+		}
+		verifiedFor = &dbg;
+		return true;
+	}
 
+	//从文件读取pcode并执行（使用内存中的符号表）
+	void interpret(SymbolTable& symTable, string file) {
+		if (!loadCodeFile(file)) return;
+		interpret(symTable);
 	}
 
-	void printCodeFile(string file) {
-		fstream f;
-		f.open(file, ios::out);
-		if (!f.is_open()) {
-			cerr << file << " can't open" << endl;
-			exit(1);
-		}
-		for (int i = 0; i < code.size(); i++) {
-			f<< i << ": " << code[i].op << " " << code[i].L << " " << code[i].A << endl;
-		}
-		cout << "pcodeļ," << file << endl;
-		f.close();
+	//从文件读取pcode及其调试信息并执行，无需重新编译
+	void interpret(string file) {
+		DebugInfo dbg;
+		if (!loadProgram(file, dbg)) return;
+		interpret(dbg);
 	}
 
-	//ļȡpcodeִ
-	void interpret(SymbolTable& symTable, string file) {
+	//读取pcode文件及其调试信息旁路文件，.img为二进制映像
+	bool loadProgram(string file, DebugInfo& dbg) {
+		if (file.size() > 4 && file.compare(file.size() - 4, 4, ".img") == 0) return loadImage(file, dbg);
+		if (!loadCodeFile(file)) return false;
+		if (!dbg.load(debugFileOf(file))) return false;
+		lines = dbg.lines;
+		return verify(dbg);
+	}
+
+	//从文件读取pcode
+	bool loadCodeFile(string file) {
 		ifstream ifs(file);
 		if (!ifs.is_open()) {
-			cerr << "޷ Pcode ļ: " << file << endl;
-			return;
+			cerr << "无法打开 Pcode 文件: " << file << endl;
+			return false;
 		}
 
 		code.clear();
@@ -596,19 +1032,29 @@ public:
 			return s.substr(l, r - l + 1);
 			};
 
+		// 字段必须是完整的整数，否则报告所在行
+		auto toInt = [](const string& t, int& v) {
+			size_t used = 0;
+			try { v = stoi(t, &used); }
+			catch (...) { return false; }
+			return used == t.size();
+			};
+
 		string line;
+		int lineNo = 0;
 		while (std::getline(ifs, line)) {
+			lineNo++;
 			line = trim(line);
 			if (line.empty()) continue;
 
-			// ʽ: INDEX: OP L A
+			// 期望格式: INDEX: OP L A
 			size_t colon = line.find(':');
 			if (colon == string::npos) continue;
 
 			string after = trim(line.substr(colon + 1));
 			if (after.empty()) continue;
 
-			//  op, L, AֶԿհ׷ָ
+			// 解析 op, L, A（三个字段以空白分隔）
 			size_t pos = 0;
 			size_t next = after.find_first_of(" \t", pos);
 			string opStr;
@@ -633,33 +1079,560 @@ public:
 					Ls = after.substr(pos, next - pos);
 					pos = after.find_first_not_of(" \t", next);
 				}
-				try { L = stoi(Ls); }
-				catch (...) { L = 0; }
+				if (!toInt(Ls, L) || L < INT16_MIN || L > INT16_MAX) {
+					cerr << file << " 第 " << lineNo << " 行：层次 " << Ls << " 无效" << endl;
+					return false;
+				}
 			}
 			if (pos != string::npos && pos < after.size()) {
 				next = after.find_first_of(" \t", pos);
 				string As;
 				if (next == string::npos) As = after.substr(pos);
 				else As = after.substr(pos, next - pos);
-				try { A = stoi(As); }
-				catch (...) { A = 0; }
+				if (!toInt(As, A)) {
+					cerr << file << " 第 " << lineNo << " 行：位移量 " << As << " 无效" << endl;
+					return false;
+				}
 			}
 
 			Ins instruction;
-			instruction.op = opStr;
-			instruction.L = L;
-			instruction.A = A;
+			if (!insFromText(opStr, L, A, instruction)) {
+				cerr << "无法识别的 Pcode 指令: " << line << endl;
+				return false;
+			}
 			code.push_back(instruction);
 		}
 
 		ifs.close();
 
-		//  emit ԼPC Ϊ볤
+		// 与 emit 的约定：PC 为代码长度
 		PC = static_cast<int>(code.size());
+		lines.assign(code.size(), SrcPos());
+		return true;
+	}
 
-		// еĽִУļ汾
-		interpret(symTable);
+private:
+	BinTrace btrace; // 二进制轨迹（-trace=bin）
+	Profiler profile; // 执行剖析（-profile）
+
+	// 分层执行计数（只在Tiered实例中更新）
+	vector<long long> callCount; // 各过程被解释执行调用的次数
+	vector<long long> loopCount; // 以各地址为循环头的回边执行次数
+	vector<bool> procNative;     // 已改用本机代码的过程
+	struct TierEvent {
+		int proc;        // 过程下标
+		int pc;          // OSR的循环头地址，过程整体升级时为-1
+		long long count; // 升级时的计数
+	};
+	vector<TierEvent> tierEvents;
+	long long osrEntries = 0;    // 经回边转入本机代码的次数
+
+	void tierStart(const DebugInfo& dbg) {
+		callCount.assign(dbg.procs.size(), 0);
+		procNative.assign(dbg.procs.size(), false);
+		loopCount.assign(code.size(), 0);
+		tierEvents.clear();
+		osrEntries = 0;
 	}
 
+	// 计数超过阈值：过程proc整体（pc为-1）或其循环头pc改用本机代码，本机层不可用时返回false
+	bool tierUp(int proc, int pc, long long count) {
+		if (!tier->ready()) return false;
+		if (pc < 0) {
+			procNative[proc] = true;
+			tierEvents.push_back({ proc, pc, count });
+		}
+		else {
+			if (count == tier_loop) tierEvents.push_back({ proc, pc, count });
+			osrEntries++;
+		}
+		return true;
+	}
+
+	void printTierStats() {
+		if (!stats_mode || verifiedFor == nullptr) return;
+		const DebugInfo& dbg = *verifiedFor;
+		cout << "分层执行：调用阈值 " << tier_call << " 次，循环阈值 " << tier_loop << " 次";
+		if (tierEvents.empty()) {
+			cout << "，没有过程升级" << endl;
+			return;
+		}
+		cout << "，" << tier->describe() << endl;
+		for (const TierEvent& e : tierEvents) {
+			cout << "  " << dbg.procs[e.proc].name;
+			if (e.pc < 0) cout << "：调用 " << e.count << " 次，之后的调用改用本机代码" << endl;
+			else cout << "：地址 " << e.pc << " 处的循环执行 " << e.count << " 次，转入本机代码（OSR）" << endl;
+		}
+		cout << "  经循环回边转入本机代码 " << osrEntries << " 次，执行指令条数不含本机代码" << endl;
+		for (size_t k = 1; k < callCount.size(); k++) {
+			cout << "  " << dbg.procs[k].name << "：解释执行调用 " << callCount[k] << " 次" << endl;
+		}
+	}
+
+	// 主程序结束
+	void finish(long long count) {
+		output.flush();
+		cout << "程序结束" << endl;
+		steps = count;
+		printStats();
+		if (tier != nullptr) printTierStats();
+	}
+
+	/*
+	跟踪条件：每隔trace_every步记录一步、只在指定过程（含其调用的过程）执行期间记录
+	两者合并为一个倒计数，取指时只判断一次是否减到0；不在指定过程内时倒计数为极大值
+	*/
+	long long traceCountdown = 1; // 距下一次记录的步数
+	bool stepTraced = false;      // 本步是否记录
+	bool traceSynced = false;     // 上一步已记录栈，本步只需记录写入的单元
+	int tracePc = 0;              // 本步的地址和指令
+	Ins traceIns;
+	vector<int> traceSlots;       // 本步写入的栈单元
+	int procDepth = 0;            // 指定过程在调用栈中的个数
+
+	/*
+	环形缓冲区（-trace-ring=N）：只保留最近N步，结束或出错时写出
+	每步只存该步写入的栈单元和活动记录的变化，另存最早一步之前的栈作为起点，
+	步被覆盖时并入起点，写出时从起点逐步重放得到各步的完整栈
+	*/
+	struct RingStep {
+		int pc = 0;
+		Ins ins;
+		string marker;  // newAc/back 标记
+		int top = -1;   // 执行后的栈顶，-1为该步出错未执行完
+		bool full = false; // 此前有未记录的步：writes为[0, top)全部单元，frames为全部活动记录
+		vector<pair<int, int>> writes; // 写入的单元（下标，值）
+		vector<pair<int, const ProcInfo*>> frames;
+		pair<int, const ProcInfo*> pushed; // CAL 建立的活动记录
+	};
+	vector<RingStep> ring;
+	long long ringCount = 0; // 进入环形缓冲区的总步数
+	vector<int> ringStack;   // 环形缓冲区中最早一步之前的栈
+	vector<pair<int, const ProcInfo*>> ringFrames;
+	inline static Pcode* running = nullptr; // 正在执行的实例，栈溢出终止前由它写出环形缓冲区
+
+	bool traceActive() const { return trace_proc.empty() || procDepth > 0; }
+	RingStep& ringCur() { return ring[(ringCount - 1) % ring.size()]; }
+
+	void traceStart(const DebugInfo& dbg) {
+		procDepth = trace_proc == dbg.procs[0].name ? 1 : 0;
+		traceCountdown = traceActive() ? 1 : LLONG_MAX;
+		stepTraced = false;
+		traceSynced = false;
+		ring.assign(trace_ring, RingStep());
+		ringCount = 0;
+		ringStack.clear();
+		ringFrames.clear();
+		running = this;
+		onFatal = []() { if (running) running->dumpRing(); };
+	}
+
+	// 跟踪输出，文本写入 pcode_output.txt，二进制写入 btrace，环形模式写入ring
+	void traceFetch(int addr, const Ins& instr) {
+		stepTraced = --traceCountdown == 0;
+		if (!stepTraced) {
+			traceSynced = false;
+			return;
+		}
+		traceCountdown = trace_every;
+		tracePc = addr;
+		traceIns = instr;
+		if (!ring.empty()) {
+			ringCount++;
+			RingStep& r = ringCur();
+			if (ringCount > (long long)ring.size()) replayStep(r, ringStack, ringFrames);//覆盖最早一步前并入起点
+			r.pc = addr;
+			r.ins = instr;
+			r.marker.clear();
+			r.top = -1;
+			return;
+		}
+		if (trace_binary) {
+			btrace.step(addr);
+			return;
+		}
+		if(key)cout<<addr<<": " << insText(instr) << endl;
+		File << addr << ": " << insText(instr) << endl;
+	}
+	void traceStack(Activation& Ac) {
+		if (!stepTraced) return;
+		if (ring.empty() && !trace_binary) {
+			Ac.printStack();
+			return;
+		}
+		if (traceSynced) stepWrites(Ac, traceSlots);
+		else allSlots(Ac, traceSlots);
+		if (!ring.empty()) {
+			RingStep& r = ringCur();
+			r.top = Ac.top;
+			r.full = !traceSynced;
+			r.writes.clear();
+			for (int i : traceSlots) r.writes.push_back({ i, Ac.stack[i] });
+			if (r.full) r.frames = Ac.frames;
+			else if (traceIns.f == op::CAL) r.pushed = Ac.frames.back();
+		}
+		else btrace.stack(Ac.stack, Ac.top, traceSlots);
+		traceSynced = true;
+	}
+	// 把环形缓冲区中的一步作用到栈和活动记录表上
+	void replayStep(const RingStep& r, vector<int>& st, vector<pair<int, const ProcInfo*>>& frames) {
+		if (r.top < 0) return;
+		if (r.full) frames = r.frames;
+		else if (r.ins.f == op::CAL) frames.push_back(r.pushed);
+		else if (r.ins.f == op::RET) frames.pop_back();
+		if ((int)st.size() < r.top) st.resize(r.top, 0);
+		for (auto& w : r.writes) st[w.first] = w.second;
+	}
+	/*
+	本步指令写入的栈单元，在指令执行后调用：结果入栈的指令写新栈顶，存储指令写目标变量，
+	调用写新活动记录的头部和ID区；弹栈、跳转、返回只移动栈顶或pc，不写单元
+	*/
+	void stepWrites(Activation& Ac, vector<int>& slots) {
+		slots.clear();
+		const Ins* w = code.data() + tracePc + 1; // 超级指令的操作数
+		switch (traceIns.f) {
+		case op::STO:
+			if (traceIns.L != -1) slots.push_back(Ac.display[traceIns.L] + traceIns.A + 4);//L为-1时存入实参，调用时才写栈
+			break;
+		case op::LSTO:
+			slots.push_back(Ac.display[w[0].L] + w[0].A + 4);
+			break;
+		case op::LLOS:
+		case op::LDOS:
+			slots.push_back(Ac.display[w[2].L] + w[2].A + 4);
+			break;
+		case op::CAL:
+			for (int i = Ac.base; i < Ac.top; i++) slots.push_back(i);
+			break;
+		case op::DUP:
+			slots.push_back(Ac.top - 2);
+			slots.push_back(Ac.top - 1);
+			break;
+		case op::LIT: case op::LOD: case op::RED: case op::LLO: case op::LDO:
+		case op::NEG: case op::ODD: case op::ADD: case op::SUB: case op::MUL: case op::DIV:
+		case op::EQ: case op::NE: case op::LT: case op::LE: case op::GT: case op::GE:
+			slots.push_back(Ac.top - 1);
+			break;
+		default:
+			break;
+		}
+	}
+	// 此前有未记录的步，其写入无从得知，改为记录[0, top)全部单元
+	void allSlots(Activation& Ac, vector<int>& slots) {
+		slots.resize(Ac.top);
+		for (int i = 0; i < Ac.top; i++) slots[i] = i;
+	}
+	void traceMarker(Activation& Ac, const string& marker) {
+		if (!ring.empty()) {
+			if (ringCount > 0) ringCur().marker += "\n" + marker + "\n";
+		}
+		else if (marker[0] == 'n') Ac.traceCall();
+		else Ac.traceReturn();
+	}
+	void traceCall(Activation& Ac, int proc) {
+		if (!trace_proc.empty() && Ac.name == trace_proc && ++procDepth == 1) {
+			traceCountdown = 1;
+		}
+		if (!traceActive()) return;
+		if (trace_binary && ring.empty()) btrace.call(proc, Ac.base);
+		else traceMarker(Ac, "newAc:" + Ac.name);
+	}
+	void traceReturn(Activation& Ac, const ProcInfo* left) {
+		if (traceActive()) {
+			if (trace_binary && ring.empty()) btrace.back(Ac.layer);
+			else traceMarker(Ac, "back " + to_string(Ac.layer));
+		}
+		if (!trace_proc.empty() && left->name == trace_proc && --procDepth == 0) {
+			traceCountdown = LLONG_MAX;
+		}
+	}
+
+	// 把环形缓冲区中的最近若干步按文本轨迹格式写入 pcode_output.txt
+	void dumpRing() {
+		if (ring.empty() || ringCount == 0) return;
+		running = nullptr;
+		ofstream out("pcode_output.txt", ios::out);
+		if (!out.is_open()) {
+			cerr << "无法打开输出文件" << endl;
+			return;
+		}
+		long long n = min<long long>(ringCount, ring.size());
+		Activation view;
+		view.stack = ringStack;
+		view.frames = ringFrames;
+		for (long long k = ringCount - n; k < ringCount; k++) {
+			RingStep& r = ring[k % ring.size()];
+			out << r.pc << ": " << insText(r.ins) << endl << r.marker;
+			if (r.top < 0) continue;
+			replayStep(r, view.stack, view.frames);
+			view.top = r.top;
+			int frame = view.frames.size() - 1;
+			for (int i = view.top - 1; i >= 0; i--) {
+				out << "[" << i << "]: " << view.slotText(i, frame) << endl;
+			}
+		}
+		ring.clear();
+		cout << "最近 " << n << " 步执行轨迹已输出到文件,pcode_output.txt" << endl;
+	}
+	/*
+	解释器主循环，Threaded为true时使用直接线索化分派：
+	每条指令执行完后直接取下一条并经标签地址表跳到其处理代码，不再回到switch
+	两种分派共用同一份处理代码，编译器不支持标签地址时只有switch分派
+	Traced为false时不生成任何跟踪输出代码，主循环中没有I/O
+	Tiered为true时统计调用和循环回边次数，超过阈值交给本机层（分层执行），为false时不生成计数代码
+	Profiled为true时按地址计数并记录过程调用/返回（-profile），为false时不生成剖析代码
+	*/
+	template<bool Threaded, bool Traced, bool Tiered = false, bool Profiled = false>
+	void run(const DebugInfo& dbg) {
+		int pc = 0;
+		Activation Ac; // 活动记录（栈式），返回地址存于活动记录中
+		int maxLevel = 0;
+		for (const ProcInfo& p : dbg.procs) maxLevel = max(maxLevel, p.level);
+		Ac.init(dbg.procs[0], maxLevel, maxStack[0]); // 初始化活动记录栈
+		vector<pair<int, int>> args; // 新活动记录的参数（偏移，值），按STO顺序传入
+		Ins instr;
+		const Ins* text = code.data(); // 取指不经过getInstruction，代码已通过verify，不再检查地址
+		long long count = 0; // 执行指令条数，结束时写回steps
+
+#ifdef PL0_THREADED
+		// 下标为操作码，顺序与 enum class op 一致
+		static const void* const dispatch[] = {
+			&&L_LIT, &&L_LOD, &&L_STO, &&L_CAL, &&L_INT, &&L_JMP, &&L_JPC, &&L_RED, &&L_WRT,
+			&&L_RET, &&L_NEG, &&L_ADD, &&L_SUB, &&L_MUL, &&L_DIV, &&L_ODD,
+			&&L_EQ, &&L_NE, &&L_LT, &&L_LE, &&L_GT, &&L_GE, &&L_DUP,
+			&&L_JPCEQ, &&L_JPCNE, &&L_JPCLT, &&L_JPCLE, &&L_JPCGT, &&L_JPCGE,
+			&&L_LLOS, &&L_LDOS, &&L_LLO, &&L_LDO, &&L_LLJ, &&L_LDJ, &&L_LSTO,
+		};
+		static_assert(sizeof(dispatch) / sizeof(dispatch[0]) == (size_t)op::COUNT, "dispatch表与操作码不一致");
+#define VM_CASE(x) case op::x: L_##x:
+#define VM_NEXT() { if (Traced) traceStack(Ac); if (Threaded) { VM_FETCH(); goto *dispatch[(int)instr.f]; } } break
+#else
+#define VM_CASE(x) case op::x:
+#define VM_NEXT() if (Traced) traceStack(Ac); break
+#endif
+#define VM_FETCH() instr = text[pc++]; count++; if (Traced) traceFetch(pc - 1, instr); if (Profiled) profile.hits[pc - 1]++
+
+		while (1) {
+			VM_FETCH();
+			switch (instr.f) {
+			VM_CASE(LIT)// 常量入栈
+			{
+				Ac.push(instr.A);
+				VM_NEXT();
+			}
+			VM_CASE(LOD)// 变量/参数入栈
+			{
+				Ac.push(Ac.getIdVal(instr.L, instr.A + 4));
+				VM_NEXT();
+			}
+			VM_CASE(STO)// 栈顶值存入变量/参数
+			{
+				int val = Ac.pop();
+
+				if (instr.L == -1) {// 新活动的变量存储
+					args.push_back({ instr.A + 4, val });
+				}
+				else {
+					*Ac.getId(instr.L, instr.A + 4) = val;
+				}
+				VM_NEXT();
+			}
+			VM_CASE(CAL)// 过程调用
+			{
+				const ProcInfo* proc = entryProc[instr.A];//verify已确认是过程入口
+				if (Tiered) {
+					int k = proc - dbg.procs.data();
+					if (procNative[k] || (++callCount[k] >= tier_call && tierUp(k, -1, callCount[k]))) {
+						int r = tier->call(k, Ac, args);
+						args.clear();
+						if (r != 2) return;//运行时错误
+						VM_NEXT();
+					}
+				}
+				// 初始化新活动记录
+				Ac.newAc(*proc, pc, maxStack[proc - dbg.procs.data()]);
+				if (Traced) traceCall(Ac, proc - dbg.procs.data());
+				if (Profiled) profile.enter(proc - dbg.procs.data(), count);
+				pc = instr.A;
+				
+				// 传递参数
+				for (auto& arg : args) {
+					*Ac.getId(Ac.define_layer, arg.first) = arg.second;
+				}
+				args.clear();
+				VM_NEXT();
+			}
+			VM_CASE(INT)// 开辟数据区（活动记录连同操作数栈空间已在调用时分配）
+				VM_NEXT();
+			VM_CASE(JMP)// 无条件跳转
+				// 向回跳转为循环回边；循环头处操作数栈与实参均为空时可转入本机代码
+				if (Tiered && instr.A < pc && ++loopCount[instr.A] >= tier_loop && args.empty()) {
+					int k = Ac.frames.back().second - dbg.procs.data();
+					if (tierUp(k, instr.A, loopCount[instr.A])) {
+						int r = tier->enter(instr.A, Ac);
+						if (r == 0) {
+							finish(count);
+							return;
+						}
+						if (r != 2) return;//运行时错误
+						pc = Ac.returnAc();
+						VM_NEXT();
+					}
+				}
+				pc = instr.A;
+				VM_NEXT();
+			VM_CASE(JPC)// 条件跳转
+			{
+				int cond = Ac.pop();
+				if (cond == 0) {
+					pc = instr.A;
+				}
+				VM_NEXT();
+			}
+			VM_CASE(JPCEQ)// 比较后条件跳转
+			VM_CASE(JPCNE)
+			VM_CASE(JPCLT)
+			VM_CASE(JPCLE)
+			VM_CASE(JPCGT)
+			VM_CASE(JPCGE)
+			{
+				int b = Ac.pop();
+				int a = Ac.pop();
+				int cond = 0;
+				evalOpr(jumpCmp(instr.f), a, b, cond);
+				if (cond == 0) {
+					pc = instr.A;
+				}
+				VM_NEXT();
+			}
+			VM_CASE(RET)// 过程返回
+			{
+				if (Ac.frames.size() == 1) {
+					finish(count);
+					return;
+				}
+				const ProcInfo* left = Ac.frames.back().second;
+				pc = Ac.returnAc();
+				if (Profiled) profile.leave(count);
+				if (Traced) traceReturn(Ac, left);
+				VM_NEXT();
+			}
+			VM_CASE(NEG)// 取负
+			{
+				int val = Ac.pop();
+				Ac.push((int)(0u - (unsigned)val));
+				VM_NEXT();
+			}
+			VM_CASE(DIV)// 除法
+			{
+				int b = Ac.pop();
+				int a = Ac.pop();
+				int result = 0;
+				if (!evalOpr(op::DIV, a, b, result)) {
+					runtimeError(b == 0 ? "除以零" : "除法溢出");
+					return;
+				}
+				Ac.push(result);
+				VM_NEXT();
+			}
+			VM_CASE(ADD)// 加法
+			VM_CASE(SUB)// 减法
+			VM_CASE(MUL)// 乘法
+			VM_CASE(EQ)// 相等
+			VM_CASE(NE)// 不等
+			VM_CASE(LT)// 小于
+			VM_CASE(LE)// 小于等于
+			VM_CASE(GT)// 大于
+			VM_CASE(GE)// 大于等于
+			{
+				int b = Ac.pop();
+				int a = Ac.pop();
+				int result = 0;
+				evalOpr(instr.f, a, b, result);
+				Ac.push(result);
+				VM_NEXT();
+			}
+			VM_CASE(ODD)// 奇偶判断
+			{
+				int a = Ac.pop();
+				Ac.push(a % 2);
+				VM_NEXT();
+			}
+			VM_CASE(DUP)// 复制栈顶
+			{
+				int val = Ac.pop();
+				Ac.push(val);
+				Ac.push(val);
+				VM_NEXT();
+			}
+			VM_CASE(RED)// 读入值入栈
+			{
+				int val = 0;
+				if (!input.next(val)) return;
+				Ac.push(val);
+				VM_NEXT();
+			}
+			VM_CASE(WRT)// 栈顶值输出
+				output.put(Ac.pop());
+				VM_NEXT();
+			// 超级指令：操作数取自其后的指令，执行完跳过这些指令
+			VM_CASE(LLOS)// 变量 op 常量 -> 变量
+			VM_CASE(LDOS)// 变量 op 变量 -> 变量
+			{
+				const Ins* w = text + pc;
+				int a = Ac.getIdVal(instr.L, instr.A + 4);
+				int b = instr.f == op::LLOS ? w[0].A : Ac.getIdVal(w[0].L, w[0].A + 4);
+				int result = 0;
+				if (!evalOpr(w[1].f, a, b, result)) {
+					runtimeError(b == 0 ? "除以零" : "除法溢出");
+					return;
+				}
+				*Ac.getId(w[2].L, w[2].A + 4) = result;
+				pc += 3;
+				VM_NEXT();
+			}
+			VM_CASE(LLO)// 变量 op 常量 入栈
+			VM_CASE(LDO)// 变量 op 变量 入栈
+			{
+				const Ins* w = text + pc;
+				int a = Ac.getIdVal(instr.L, instr.A + 4);
+				int b = instr.f == op::LLO ? w[0].A : Ac.getIdVal(w[0].L, w[0].A + 4);
+				int result = 0;
+				if (!evalOpr(w[1].f, a, b, result)) {
+					runtimeError(b == 0 ? "除以零" : "除法溢出");
+					return;
+				}
+				Ac.push(result);
+				pc += 2;
+				VM_NEXT();
+			}
+			VM_CASE(LLJ)// 变量与常量比较后条件跳转
+			VM_CASE(LDJ)// 变量与变量比较后条件跳转
+			{
+				const Ins* w = text + pc;
+				int a = Ac.getIdVal(instr.L, instr.A + 4);
+				int b = instr.f == op::LLJ ? w[0].A : Ac.getIdVal(w[0].L, w[0].A + 4);
+				int cond = 0;
+				evalOpr(jumpCmp(w[1].f), a, b, cond);
+				pc = cond == 0 ? w[1].A : pc + 2;
+				VM_NEXT();
+			}
+			VM_CASE(LSTO)// 常量存入变量
+			{
+				const Ins* w = text + pc;
+				*Ac.getId(w[0].L, w[0].A + 4) = instr.A;
+				pc += 1;
+				VM_NEXT();
+			}
+			default:
+				cerr << "未知操作码: " << insText(instr) << endl;
+				return;
+			}
+		}
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_FETCH
+	}
 };
 
+
@@ -0,0 +1,256 @@
+/*
+执行剖析（-profile）
+取指时按地址计数，过程调用/返回时记录指令条数和时间，结束时汇总为按过程、按操作码、按指令的报告
+另输出折叠调用栈（每行"主程序;过程;... 自身指令条数"），可直接交给 flamegraph.pl 等工具生成火焰图
+调试信息中有各指令的源码位置时，按源码行汇总并输出标注了执行次数和时间的源程序清单
+只在剖析实例的解释器主循环中调用，关闭时没有任何开销
+*/
+
+#pragma once
+#include<fstream>
+#include<iostream>
+#include<iomanip>
+#include<string>
+#include<vector>
+#include<chrono>
+#include<algorithm>
+#include"DebugInfo.h"
+
+using namespace std;
+
+class Profiler {
+public:
+	vector<long long> hits; // 各地址执行次数（超级指令计在首条）
+
+	void start(int codeSize, int procCount) {
+		hits.assign(codeSize, 0);
+		calls.assign(procCount, 0);
+		inclCount.assign(procCount, 0);
+		inclTime.assign(procCount, 0);
+		selfTime.assign(procCount, 0);
+		onStack.assign(procCount, 0);
+		nodes.clear();
+		nodes.push_back({ 0, -1, 0, {} });
+		frames.clear();
+		frames.push_back({ 0, 0, 0, now(), 0 });
+		calls[0] = 1;
+		onStack[0] = 1;
+		mark = 0;
+	}
+
+	// 进入过程proc，count为此前已执行的指令条数
+	void enter(int proc, long long count) {
+		Frame& caller = frames.back();
+		nodes[caller.node].self += count - mark;
+		mark = count;
+		calls[proc]++;
+		onStack[proc]++;
+		frames.push_back({ proc, child(caller.node, proc), count, now(), 0 });
+	}
+
+	// 返回到调用者
+	void leave(long long count) {
+		Frame f = frames.back();
+		frames.pop_back();
+		nodes[f.node].self += count - mark;
+		mark = count;
+		double dt = now() - f.start;
+		selfTime[f.proc] += dt - f.childTime;
+		if (--onStack[f.proc] == 0) {//递归时只计最外层活动记录，含调用的值不重复累加
+			inclCount[f.proc] += count - f.startCount;
+			inclTime[f.proc] += dt;
+		}
+		if (!frames.empty()) frames.back().childTime += dt;
+	}
+
+	/*
+	写出报告：text为各地址的指令文本，opKey为各地址计入的操作码名，procOf为各地址所属过程
+	出错提前结束时尚未返回的活动记录按结束时刻计算
+	*/
+	void write(const string& reportFile, const string& foldedFile, const vector<string>& text,
+		const vector<string>& opKey, const vector<int>& procOf, const DebugInfo& dbg) {
+		long long total = 0;
+		for (long long h : hits) total += h;
+		while (!frames.empty()) leave(total);
+		double totalTime = inclTime[0];
+
+		int procCount = dbg.procs.size();
+		vector<long long> selfCount(procCount, 0);
+		for (size_t i = 0; i < hits.size(); i++) {
+			if (procOf[i] >= 0) selfCount[procOf[i]] += hits[i];
+		}
+
+		ofstream out(reportFile, ios::out);
+		if (!out.is_open()) {
+			cerr << "无法打开剖析报告文件: " << reportFile << endl;
+			return;
+		}
+		out << fixed;
+		out << "剖析报告：执行指令 " << total << " 条，用时 " << setprecision(3) << totalTime * 1000 << " 毫秒" << endl;
+
+		out << "\n按过程（自身不含其调用的过程，递归时含调用只计最外层）" << endl;
+		out << left << setw(16) << "过程" << right << setw(10) << "调用" << setw(14) << "自身指令" << setw(8) << "%"
+			<< setw(14) << "含调用指令" << setw(12) << "自身毫秒" << setw(12) << "含调用毫秒" << endl;
+		vector<int> order(procCount);
+		for (int k = 0; k < procCount; k++) order[k] = k;
+		sort(order.begin(), order.end(), [&](int a, int b) { return selfCount[a] > selfCount[b]; });
+		for (int k : order) {
+			out << left << setw(16) << dbg.procs[k].name << right << setw(10) << calls[k] << setw(14) << selfCount[k]
+				<< setw(8) << setprecision(2) << percent(selfCount[k], total) << setw(14) << inclCount[k]
+				<< setw(12) << setprecision(3) << selfTime[k] * 1000 << setw(12) << inclTime[k] * 1000 << endl;
+		}
+
+		out << "\n按操作码" << endl;
+		vector<pair<string, long long>> ops;
+		for (size_t i = 0; i < hits.size(); i++) {
+			if (hits[i] == 0) continue;
+			auto it = find_if(ops.begin(), ops.end(), [&](const pair<string, long long>& p) { return p.first == opKey[i]; });
+			if (it == ops.end()) ops.push_back({ opKey[i], hits[i] });
+			else it->second += hits[i];
+		}
+		sort(ops.begin(), ops.end(), [](const pair<string, long long>& a, const pair<string, long long>& b) { return a.second > b.second; });
+		for (auto& p : ops) {
+			out << "  " << left << setw(8) << p.first << right << setw(14) << p.second
+				<< setw(8) << setprecision(2) << percent(p.second, total) << endl;
+		}
+
+		out << "\n按指令（地址: 指令  执行次数  %  源码行:列  所属过程）" << endl;
+		for (size_t i = 0; i < hits.size(); i++) {
+			SrcPos p = dbg.posOf(i);
+			string at = p.row > 0 ? to_string(p.row) + ":" + to_string(p.column) : "-";
+			out << setw(6) << i << ": " << left << setw(14) << text[i] << right << setw(14) << hits[i]
+				<< setw(8) << setprecision(2) << percent(hits[i], total) << setw(10) << at << "  "
+				<< (procOf[i] >= 0 ? dbg.procs[procOf[i]].name : "（不可达）") << endl;
+		}
+		out.close();
+		cout << "剖析报告已输出到文件," << reportFile << endl;
+
+		ofstream folded(foldedFile, ios::out);
+		if (!folded.is_open()) {
+			cerr << "无法打开折叠调用栈文件: " << foldedFile << endl;
+			return;
+		}
+		for (size_t n = 0; n < nodes.size(); n++) {
+			if (nodes[n].self == 0) continue;
+			string path;
+			for (int k = n; k >= 0; k = nodes[k].parent) path = dbg.procs[nodes[k].proc].name + (path.empty() ? "" : ";" + path);
+			folded << path << " " << nodes[n].self << endl;
+		}
+		cout << "折叠调用栈已输出到文件," << foldedFile << endl;
+	}
+
+	/*
+	源码行热点：各行的执行指令条数和时间，在write之后调用
+	只在调用/返回处计时，某条指令的时间按其所属过程的自身时间依指令条数分摊，为估计值
+	有代码但未执行的行计数为0，没有代码的行不标注
+	*/
+	void writeSource(const string& listFile, const string& srcFile, const vector<int>& procOf, const DebugInfo& dbg) {
+		if (dbg.lines.empty()) {
+			cerr << "调试信息中没有源码位置，不输出源码行热点" << endl;
+			return;
+		}
+		ifstream src(srcFile);
+		if (!src.is_open()) {
+			cerr << "无法打开源文件: " << srcFile << "（可用 -profile-src=<文件> 指定），不输出源码行热点" << endl;
+			return;
+		}
+		vector<string> source;
+		string line;
+		while (getline(src, line)) {
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			source.push_back(line);
+		}
+
+		int procCount = dbg.procs.size();
+		vector<long long> selfCount(procCount, 0);
+		long long total = 0;
+		for (size_t i = 0; i < hits.size(); i++) {
+			total += hits[i];
+			if (procOf[i] >= 0) selfCount[procOf[i]] += hits[i];
+		}
+		vector<long long> rowCount(source.size() + 1, 0);
+		vector<double> rowTime(source.size() + 1, 0);
+		vector<bool> hasCode(source.size() + 1, false);
+		for (size_t i = 0; i < hits.size(); i++) {
+			int row = dbg.posOf(i).row;
+			if (row <= 0 || row > (int)source.size() || procOf[i] < 0) continue;
+			int k = procOf[i];
+			hasCode[row] = true;
+			rowCount[row] += hits[i];
+			if (selfCount[k] > 0) rowTime[row] += selfTime[k] * hits[i] / selfCount[k];
+		}
+
+		ofstream out(listFile, ios::out);
+		if (!out.is_open()) {
+			cerr << "无法打开源码行热点文件: " << listFile << endl;
+			return;
+		}
+		out << fixed;
+		out << "源码行热点：" << srcFile << "，执行指令 " << total << " 条（时间按所属过程的自身时间依指令条数分摊，为估计值）" << endl;
+
+		vector<int> order;
+		for (int r = 1; r <= (int)source.size(); r++) {
+			if (rowCount[r] > 0) order.push_back(r);
+		}
+		sort(order.begin(), order.end(), [&](int a, int b) { return rowCount[a] > rowCount[b]; });
+		if (order.size() > 10) order.resize(10);
+		out << "\n最热的行（行号  执行指令  %  毫秒  源码）" << endl;
+		for (int r : order) {
+			size_t b = source[r - 1].find_first_not_of(" \t");
+			out << setw(6) << r << setw(14) << rowCount[r] << setw(8) << setprecision(2) << percent(rowCount[r], total)
+				<< setw(12) << setprecision(3) << rowTime[r] * 1000 << "  "
+				<< (b == string::npos ? "" : source[r - 1].substr(b)) << endl;
+		}
+
+		out << "\n源程序（执行指令  %  毫秒 | 行号  源码）" << endl;
+		for (int r = 1; r <= (int)source.size(); r++) {
+			if (hasCode[r]) {
+				out << setw(14) << rowCount[r] << setw(8) << setprecision(2) << percent(rowCount[r], total)
+					<< setw(12) << setprecision(3) << rowTime[r] * 1000;
+			}
+			else {
+				out << string(34, ' ');
+			}
+			out << " | " << setw(4) << r << "  " << source[r - 1] << endl;
+		}
+		cout << "源码行热点已输出到文件," << listFile << endl;
+	}
+
+private:
+	// 调用树结点：同一调用路径上的过程合并为一个结点
+	struct Node {
+		int proc;
+		int parent;
+		long long self;       // 该路径上自身执行的指令条数
+		vector<int> children;
+	};
+	struct Frame {
+		int proc;
+		int node;
+		long long startCount; // 进入时已执行的指令条数
+		double start;         // 进入时刻（秒）
+		double childTime;     // 其调用的过程所用时间
+	};
+
+	vector<long long> calls, inclCount;
+	vector<double> inclTime, selfTime;
+	vector<int> onStack;      // 各过程在调用栈中的个数
+	vector<Node> nodes;
+	vector<Frame> frames;
+	long long mark = 0;       // 上一次调用/返回时已执行的指令条数
+	chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+	double now() const { return chrono::duration<double>(chrono::steady_clock::now() - epoch).count(); }
+	static double percent(long long a, long long total) { return total > 0 ? 100.0 * a / total : 0; }
+
+	// 调用路径上的子结点；直接递归合并为同一结点，深递归时折叠调用栈不随深度膨胀
+	int child(int node, int proc) {
+		if (nodes[node].proc == proc) return node;
+		for (int c : nodes[node].children) {
+			if (nodes[c].proc == proc) return c;
+		}
+		nodes.push_back({ proc, node, 0, {} });
+		nodes[node].children.push_back(nodes.size() - 1);
+		return nodes.size() - 1;
+	}
+};
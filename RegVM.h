@@ -0,0 +1,509 @@
+/*
+寄存器虚拟机
+把栈式Pcode按基本块翻译为三地址寄存器指令：操作数直接是常量、变量单元（层L，偏移A）或临时寄存器
+翻译时在块内模拟操作数栈，LOD/LIT不再生成指令，运算结果直接写入STO的目标变量
+例：x := x - 1 的 LOD LIT OPR STO 四条翻译为一条 SUB x, x, 1
+生成的代码在基本块边界和过程调用处操作数栈总为空，临时寄存器不跨块存活，全局共用一组
+*/
+
+#pragma once
+#include<iostream>
+#include<vector>
+#include<string>
+#include<chrono>
+#include<cstdint>
+#include"Pcode.h"
+#include"DebugInfo.h"
+#include"config.h"
+
+using namespace std;
+
+// 寄存器指令操作码
+enum class rop : uint8_t {
+	MOV,        // d = a
+	NEG,        // d = -a
+	ODD,        // d = a % 2
+	ADD, SUB, MUL, DIV,
+	EQ, NE, LT, LE, GT, GE,   // d = a cmp b
+	JMP,        // 跳转到target
+	JF,         // a为0时跳转
+	JFEQ, JFNE, JFLT, JFLE, JFGT, JFGE, // a cmp b 不成立时跳转
+	ARG,        // 新活动记录第target个ID单元 = a
+	CAL,        // 调用过程procs[target]
+	RET,
+	RED,        // d = 读入
+	WRT         // 输出a
+};
+
+// 操作数种类
+enum class opd : uint8_t {
+	NONE,
+	CONST, // 常量，值为v
+	VAR,   // 变量，display[L]所指活动记录的第v个ID单元
+	TEMP   // 临时寄存器v
+};
+
+struct ROpd {
+	opd kind = opd::NONE;
+	int16_t L = 0;
+	int32_t v = 0;
+
+	bool operator==(const ROpd& o) const {
+		return kind == o.kind && L == o.L && v == o.v;
+	}
+};
+
+struct RIns {
+	rop f;
+	int32_t target = 0; // 跳转目标（寄存器代码地址）、过程下标或实参偏移
+	ROpd d, a, b;
+};
+
+class RegVM {
+public:
+	vector<RIns> code;        // 寄存器代码
+	vector<int> procEntry;    // 与dbg.procs对应的寄存器代码入口
+	int temps = 0;            // 临时寄存器个数
+	long long steps = 0;      // 执行的寄存器指令条数
+	string error;             // 翻译失败原因
+
+	// 翻译Pcode，遇到不满足翻译前提的代码返回false
+	bool translate(const vector<Ins>& pcode, const DebugInfo& dbg) {
+		int n = pcode.size();
+		code.clear();
+		temps = 0;
+
+		//基本块首指令：地址0、跳转目标、过程入口、跳转/返回的下一条
+		vector<bool> leader(n + 1, false);
+		leader[0] = true;
+		for (const ProcInfo& p : dbg.procs) {
+			if (p.entry >= 0 && p.entry <= n) leader[p.entry] = true;
+		}
+		for (int i = 0; i < n; i++) {
+			if (hasTarget(pcode[i].f)) {
+				if (pcode[i].A < 0 || pcode[i].A >= n) return fail(i, "跳转目标越界");
+				leader[pcode[i].A] = true;
+				leader[i + 1] = true;
+			}
+			else if (pcode[i].f == op::RET) {
+				leader[i + 1] = true;
+			}
+		}
+
+		vector<int> newAddr(n + 1, -1);
+		vector<pair<int, int>> fixups; // 寄存器指令下标, pcode目标地址
+		vector<ROpd> stack;            // 块内模拟的操作数栈
+		int producer = -1;             // 最近一条写临时寄存器的指令，STO可改写其目标
+
+		for (int i = 0; i < n; i++) {
+			if (leader[i]) {
+				if (!stack.empty()) return fail(i, "基本块入口处操作数栈不为空");
+				newAddr[i] = code.size();
+				producer = -1;
+			}
+			Ins ins = pcode[i];
+			ins.f = superHead(ins.f);//超级指令的操作数指令原样保留，按原序列翻译
+			switch (ins.f) {
+			case op::LIT:
+				stack.push_back(konst(ins.A));
+				break;
+			case op::LOD:
+				stack.push_back(var(ins.L, ins.A));
+				break;
+			case op::DUP:
+				if (stack.empty()) return fail(i, "操作数栈下溢");
+				stack.push_back(stack.back());
+				break;
+			case op::INT://寄存器虚拟机的活动记录在调用时一次分配
+				break;
+			case op::STO:
+			{
+				if (stack.empty()) return fail(i, "操作数栈下溢");
+				ROpd src = stack.back();
+				stack.pop_back();
+				if (ins.L == -1) {
+					RIns r = make(rop::ARG);
+					r.target = ins.A;
+					r.a = src;
+					code.push_back(r);
+					break;
+				}
+				ROpd dst = var(ins.L, ins.A);
+				//栈中尚未使用的旧值先复制到临时寄存器
+				bool spilled = false;
+				for (int k = 0; k < (int)stack.size(); k++) {
+					if (stack[k] == dst) {
+						RIns r = make(rop::MOV);
+						r.d = temp(k);
+						r.a = dst;
+						code.push_back(r);
+						stack[k] = r.d;
+						spilled = true;
+					}
+				}
+				bool shared = false;
+				for (const ROpd& o : stack) if (o == src) shared = true;
+				if (!spilled && !shared && src.kind == opd::TEMP && producer == (int)code.size() - 1 && code[producer].d == src) {
+					code[producer].d = dst;
+				}
+				else {
+					RIns r = make(rop::MOV);
+					r.d = dst;
+					r.a = src;
+					code.push_back(r);
+				}
+				producer = -1;
+				break;
+			}
+			case op::NEG:
+			case op::ODD:
+			{
+				if (stack.empty()) return fail(i, "操作数栈下溢");
+				RIns r = make(ins.f == op::NEG ? rop::NEG : rop::ODD);
+				r.a = stack.back();
+				stack.pop_back();
+				r.d = temp(stack.size());
+				stack.push_back(r.d);
+				producer = code.size();
+				code.push_back(r);
+				break;
+			}
+			case op::ADD: case op::SUB: case op::MUL: case op::DIV:
+			case op::EQ: case op::NE: case op::LT: case op::LE: case op::GT: case op::GE:
+			{
+				if (stack.size() < 2) return fail(i, "操作数栈下溢");
+				RIns r = make(binary(ins.f));
+				r.b = stack.back();
+				stack.pop_back();
+				r.a = stack.back();
+				stack.pop_back();
+				r.d = temp(stack.size());
+				stack.push_back(r.d);
+				producer = code.size();
+				code.push_back(r);
+				break;
+			}
+			case op::RED:
+			{
+				RIns r = make(rop::RED);
+				r.d = temp(stack.size());
+				stack.push_back(r.d);
+				producer = code.size();
+				code.push_back(r);
+				break;
+			}
+			case op::WRT:
+			{
+				if (stack.empty()) return fail(i, "操作数栈下溢");
+				RIns r = make(rop::WRT);
+				r.a = stack.back();
+				stack.pop_back();
+				code.push_back(r);
+				break;
+			}
+			case op::JMP:
+			case op::JPC:
+			case op::JPCEQ: case op::JPCNE: case op::JPCLT: case op::JPCLE: case op::JPCGT: case op::JPCGE:
+			{
+				RIns r = make(jump(ins.f));
+				if (ins.f != op::JMP) {
+					if (ins.f != op::JPC) {
+						if (stack.empty()) return fail(i, "操作数栈下溢");
+						r.b = stack.back();
+						stack.pop_back();
+					}
+					if (stack.empty()) return fail(i, "操作数栈下溢");
+					r.a = stack.back();
+					stack.pop_back();
+				}
+				fixups.push_back({ (int)code.size(), ins.A });
+				code.push_back(r);
+				break;
+			}
+			case op::CAL:
+			{
+				if (!stack.empty()) return fail(i, "过程调用处操作数栈不为空");
+				const ProcInfo* proc = dbg.findByEntry(ins.A);
+				if (proc == nullptr) return fail(i, "未找到入口地址为 " + to_string(ins.A) + " 的过程");
+				RIns r = make(rop::CAL);
+				r.target = proc - dbg.procs.data();
+				code.push_back(r);
+				break;
+			}
+			case op::RET:
+				code.push_back(make(rop::RET));
+				break;
+			default:
+				return fail(i, "无法翻译的指令 " + ::insText(ins));
+			}
+			if (i + 1 < n && leader[i + 1] && !stack.empty()) {
+				return fail(i, "基本块出口处操作数栈不为空");
+			}
+		}
+		newAddr[n] = code.size();
+
+		for (auto& f : fixups) {
+			code[f.first].target = newAddr[f.second];
+		}
+		procEntry.assign(dbg.procs.size(), 0);
+		for (int k = 0; k < (int)dbg.procs.size(); k++) {
+			int e = dbg.procs[k].entry;
+			procEntry[k] = (e >= 0 && e <= n) ? newAddr[e] : -1;
+		}
+		return true;
+	}
+
+	// 执行翻译后的寄存器代码
+	void run(const DebugInfo& dbg) {
+		int maxLevel = 0;
+		for (const ProcInfo& p : dbg.procs) maxLevel = max(maxLevel, p.level);
+		vector<int> mem(dbg.procs[0].id_count, 0); // 所有活动记录的ID单元
+		vector<int> display(maxLevel + 1, 0);       // display[层] = 该层当前活动记录在mem中的起始位置
+		vector<int> R(temps + 1, 0);                // 临时寄存器
+		vector<Frame> frames;
+		vector<pair<int, int>> args;                // 待传入新活动记录的实参（偏移，值）
+		int pc = procEntry[0];
+		int codeSize = code.size();
+
+		auto rd = [&](const ROpd& o) -> int {
+			if (o.kind == opd::CONST) return o.v;
+			if (o.kind == opd::TEMP) return R[o.v];
+			return mem[display[o.L] + o.v];
+			};
+		auto wr = [&](const ROpd& o) -> int& {
+			if (o.kind == opd::TEMP) return R[o.v];
+			return mem[display[o.L] + o.v];
+			};
+
+		steps = 0;
+		auto startTime = chrono::steady_clock::now();
+		while (1) {
+			if ((unsigned)pc >= (unsigned)codeSize) {
+				runtimeError("寄存器指令索引越界: " + to_string(pc));
+				return;
+			}
+			const RIns& r = code[pc++];
+			steps++;
+			switch (r.f) {
+			case rop::MOV: wr(r.d) = rd(r.a); break;
+			case rop::NEG: wr(r.d) = (int)(0u - (unsigned)rd(r.a)); break;
+			case rop::ODD: wr(r.d) = rd(r.a) % 2; break;
+			case rop::ADD: wr(r.d) = (int)((unsigned)rd(r.a) + (unsigned)rd(r.b)); break;
+			case rop::SUB: wr(r.d) = (int)((unsigned)rd(r.a) - (unsigned)rd(r.b)); break;
+			case rop::MUL: wr(r.d) = (int)((unsigned)rd(r.a) * (unsigned)rd(r.b)); break;
+			case rop::DIV:
+			{
+				int b = rd(r.b);
+				int result = 0;
+				if (!evalOpr(op::DIV, rd(r.a), b, result)) {
+					runtimeError(b == 0 ? "除以零" : "除法溢出");
+					return;
+				}
+				wr(r.d) = result;
+				break;
+			}
+			case rop::EQ: wr(r.d) = rd(r.a) == rd(r.b); break;
+			case rop::NE: wr(r.d) = rd(r.a) != rd(r.b); break;
+			case rop::LT: wr(r.d) = rd(r.a) < rd(r.b); break;
+			case rop::LE: wr(r.d) = rd(r.a) <= rd(r.b); break;
+			case rop::GT: wr(r.d) = rd(r.a) > rd(r.b); break;
+			case rop::GE: wr(r.d) = rd(r.a) >= rd(r.b); break;
+			case rop::JMP: pc = r.target; break;
+			case rop::JF: if (rd(r.a) == 0) pc = r.target; break;
+			case rop::JFEQ: if (!(rd(r.a) == rd(r.b))) pc = r.target; break;
+			case rop::JFNE: if (!(rd(r.a) != rd(r.b))) pc = r.target; break;
+			case rop::JFLT: if (!(rd(r.a) < rd(r.b))) pc = r.target; break;
+			case rop::JFLE: if (!(rd(r.a) <= rd(r.b))) pc = r.target; break;
+			case rop::JFGT: if (!(rd(r.a) > rd(r.b))) pc = r.target; break;
+			case rop::JFGE: if (!(rd(r.a) >= rd(r.b))) pc = r.target; break;
+			case rop::ARG:
+				args.push_back({ r.target, rd(r.a) });
+				break;
+			case rop::CAL:
+			{
+				const ProcInfo& proc = dbg.procs[r.target];
+				//与解释器同样按活动记录（头部4个单元加ID单元）计栈单元，超过 -stack 时报告栈溢出
+				if (mem.size() + proc.id_count + 4 * (frames.size() + 2) > (size_t)stack_size) {
+					runtimeError("栈溢出（栈大小 " + to_string(stack_size) + "，可用 -stack=<单元数> 调整）");
+					exit(1);
+				}
+				Frame fr;
+				fr.ret = pc;
+				fr.base = mem.size();
+				fr.level = proc.level;
+				fr.savedDisplay = display[proc.level];
+				frames.push_back(fr);
+				mem.resize(mem.size() + proc.id_count, 0);
+				display[proc.level] = fr.base;
+				for (auto& arg : args) {
+					mem[fr.base + arg.first] = arg.second;
+				}
+				args.clear();
+				pc = procEntry[r.target];
+				break;
+			}
+			case rop::RET:
+			{
+				if (frames.empty()) {
+					output.flush();
+					cout << "程序结束" << endl;
+					if (stats_mode) {
+						double sec = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+						cout << "执行寄存器指令 " << steps << " 条，用时 " << sec << " 秒，"
+							<< (sec > 0 ? (long long)(steps / sec) : 0) << " 条/秒" << endl;
+					}
+					return;
+				}
+				Frame fr = frames.back();
+				frames.pop_back();
+				display[fr.level] = fr.savedDisplay;
+				mem.resize(fr.base);
+				pc = fr.ret;
+				break;
+			}
+			case rop::RED:
+			{
+				int val = 0;
+				if (!input.next(val)) return;
+				wr(r.d) = val;
+				break;
+			}
+			case rop::WRT:
+				output.put(rd(r.a));
+				break;
+			}
+		}
+	}
+
+	void printCode() {
+		for (int i = 0; i < (int)code.size(); i++) {
+			cout << i << ": " << insText(code[i]) << endl;
+		}
+	}
+
+private:
+	struct Frame {
+		int ret;          // 返回地址
+		int base;         // ID单元在mem中的起始位置
+		int level;        // 过程层
+		int savedDisplay; // 调用前display[level]的值
+	};
+
+	bool fail(int addr, const string& msg) {
+		error = to_string(addr) + ": " + msg;
+		return false;
+	}
+
+	RIns make(rop f) {
+		RIns r;
+		r.f = f;
+		return r;
+	}
+	ROpd konst(int v) {
+		ROpd o;
+		o.kind = opd::CONST;
+		o.v = v;
+		return o;
+	}
+	ROpd var(int L, int A) {
+		ROpd o;
+		o.kind = opd::VAR;
+		o.L = L;
+		o.v = A;
+		return o;
+	}
+	ROpd temp(int k) {
+		ROpd o;
+		o.kind = opd::TEMP;
+		o.v = k;
+		if (k + 1 > temps) temps = k + 1;
+		return o;
+	}
+
+	static rop binary(op f) {
+		switch (f) {
+		case op::ADD: return rop::ADD;
+		case op::SUB: return rop::SUB;
+		case op::MUL: return rop::MUL;
+		case op::DIV: return rop::DIV;
+		case op::EQ: return rop::EQ;
+		case op::NE: return rop::NE;
+		case op::LT: return rop::LT;
+		case op::LE: return rop::LE;
+		case op::GT: return rop::GT;
+		default: return rop::GE;
+		}
+	}
+	static rop jump(op f) {
+		switch (f) {
+		case op::JMP: return rop::JMP;
+		case op::JPC: return rop::JF;
+		case op::JPCEQ: return rop::JFEQ;
+		case op::JPCNE: return rop::JFNE;
+		case op::JPCLT: return rop::JFLT;
+		case op::JPCLE: return rop::JFLE;
+		case op::JPCGT: return rop::JFGT;
+		default: return rop::JFGE;
+		}
+	}
+
+	static string opdText(const ROpd& o) {
+		switch (o.kind) {
+		case opd::CONST: return to_string(o.v);
+		case opd::VAR: return "[" + to_string(o.L) + "," + to_string(o.v) + "]";
+		case opd::TEMP: return "r" + to_string(o.v);
+		default: return "";
+		}
+	}
+	static string insText(const RIns& r) {
+		static const char* names[] = {
+			"MOV", "NEG", "ODD", "ADD", "SUB", "MUL", "DIV",
+			"EQ", "NE", "LT", "LE", "GT", "GE",
+			"JMP", "JF", "JFEQ", "JFNE", "JFLT", "JFLE", "JFGT", "JFGE",
+			"ARG", "CAL", "RET", "RED", "WRT"
+		};
+		string s = names[(int)r.f];
+		switch (r.f) {
+		case rop::JMP: return s + " " + to_string(r.target);
+		case rop::JF: return s + " " + opdText(r.a) + ", " + to_string(r.target);
+		case rop::ARG: return s + " " + to_string(r.target) + ", " + opdText(r.a);
+		case rop::CAL: return s + " " + to_string(r.target);
+		case rop::RET: return s;
+		case rop::RED: return s + " " + opdText(r.d);
+		case rop::WRT: return s + " " + opdText(r.a);
+		case rop::MOV: case rop::NEG: case rop::ODD:
+			return s + " " + opdText(r.d) + ", " + opdText(r.a);
+		default:
+			if (r.f >= rop::JFEQ && r.f <= rop::JFGE) {
+				return s + " " + opdText(r.a) + ", " + opdText(r.b) + ", " + to_string(r.target);
+			}
+			return s + " " + opdText(r.d) + ", " + opdText(r.a) + ", " + opdText(r.b);
+		}
+	}
+};
+
+// 翻译为寄存器代码后执行；不满足翻译前提时退回栈式解释器
+void interpretRegVM(Pcode& pcode, const DebugInfo& dbg) {
+	RegVM vm;
+	if (!vm.translate(pcode.code, dbg)) {
+		cerr << "寄存器虚拟机翻译失败（" << vm.error << "），改用栈式解释器" << endl;
+		pcode.interpret(dbg);
+		return;
+	}
+	if (key) vm.printCode();
+	if (stats_mode) {
+		cout << "寄存器翻译：pcode " << pcode.code.size() << " 条 -> 寄存器指令 " << vm.code.size()
+			<< " 条，临时寄存器 " << vm.temps << " 个" << endl;
+	}
+	if (!output.open(out_file) || !input.open(in_file)) return;
+	vm.run(dbg);
+	output.close();
+	input.close();
+}
+
+// 读取pcode文件及调试信息（或二进制映像）后执行
+void interpretRegVM(Pcode& pcode, const string& file) {
+	DebugInfo dbg;
+	if (!pcode.loadProgram(file, dbg)) return;
+	interpretRegVM(pcode, dbg);
+}
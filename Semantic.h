@@ -0,0 +1,151 @@
+/*
+语义检查遍
+语法分析时只记录各过程体内的标识符引用，声明收集完毕后按过程分组检查：
+未定义标识符、赋值/read目标不是变量、因子是过程、call目标不是过程及参数个数
+各过程的检查互不依赖且只读符号表，用线程池并行执行，诊断按源码位置排序合并
+*/
+
+#pragma once
+#include<string>
+#include<vector>
+#include<thread>
+#include<atomic>
+#include<algorithm>
+#include"SymbolTable.h"
+
+using namespace std;
+
+// 标识符引用种类
+enum class RefKind {
+	FACTOR,  // 表达式因子
+	ASSIGN,  // 赋值左值
+	READ,    // read目标
+	CALL     // 过程调用
+};
+
+// 过程体内的一次标识符引用
+struct SymRef {
+	string name;
+	RefKind kind;
+	int arg_count = 0;      // 调用实参个数（仅CALL）
+	int row = 0, column = 0;
+	bool resolved = true;   // 生成代码时能否找到该符号（向后引用的过程无法生成入口）
+};
+
+// 语义诊断
+struct Diagnostic {
+	int row = 0, column = 0;
+	string msg;
+};
+
+class SemanticChecker {
+public:
+	int threads = 0; // 线程数，0表示按硬件并发数
+
+	// 记录引用，scope为引用所在的过程层
+	void addRef(SymLayer* scope, const SymRef& ref) {
+		for (int i = (int)scopes.size() - 1; i >= 0; i--) {
+			if (scopes[i] == scope) {
+				refs[i].push_back(ref);
+				return;
+			}
+		}
+		scopes.push_back(scope);
+		refs.push_back({ ref });
+	}
+
+	// 记录生成代码时发现的错误（生成了占位指令），与检查结果合并，同一位置只保留一条
+	void addError(int row, int column, const string& msg) {
+		Diagnostic d;
+		d.row = row;
+		d.column = column;
+		d.msg = msg;
+		codegenErrors.push_back(d);
+	}
+
+	// 并行检查所有过程，返回按位置排序的诊断
+	vector<Diagnostic> check(const SymbolTable& symTable) {
+		int n = (int)scopes.size();
+		vector<vector<Diagnostic>> results(n);
+
+		int workers = threads > 0 ? threads : (int)thread::hardware_concurrency();
+		if (workers <= 0) workers = 1;
+		if (workers > n) workers = n;
+
+		atomic<int> next(0);
+		auto worker = [&]() {
+			int i;
+			while ((i = next.fetch_add(1)) < n) {
+				checkProc(symTable, scopes[i], refs[i], results[i]);
+			}
+			};
+		vector<thread> pool;
+		for (int t = 1; t < workers; t++) pool.emplace_back(worker);
+		worker();//当前线程也参与
+		for (thread& t : pool) t.join();
+
+		vector<Diagnostic> all;
+		for (auto& r : results) all.insert(all.end(), r.begin(), r.end());
+		all.insert(all.end(), codegenErrors.begin(), codegenErrors.end());
+		stable_sort(all.begin(), all.end(), [](const Diagnostic& a, const Diagnostic& b) {
+			return a.row != b.row ? a.row < b.row : a.column < b.column;
+			});
+		//检查遍的诊断在前，同一位置的占位错误不再重复报告
+		all.erase(unique(all.begin(), all.end(), [](const Diagnostic& a, const Diagnostic& b) {
+			return a.row == b.row && a.column == b.column;
+			}), all.end());
+		return all;
+	}
+
+private:
+	vector<SymLayer*> scopes;      // 出现引用的过程层
+	vector<vector<SymRef>> refs;   // 与scopes对应的引用列表
+	vector<Diagnostic> codegenErrors; // 生成代码时发现的错误
+
+	static void checkProc(const SymbolTable& symTable, SymLayer* scope,
+		const vector<SymRef>& procRefs, vector<Diagnostic>& out) {
+		for (const SymRef& ref : procRefs) {
+			Symbol* sym = symTable.findVisible(scope, ref.name);
+			if (sym == nullptr || !ref.resolved) {
+				report(out, ref, SymbolError(SymErrType::UNDEF, ref.name).what());
+				continue;
+			}
+			SYMBOLTYPE ty = sym->getType();
+			bool isVar = ty == SYMBOLTYPE::VAR || ty == SYMBOLTYPE::PARAM;
+			switch (ref.kind) {
+			case RefKind::FACTOR:
+				if (ty == SYMBOLTYPE::PROC) {
+					report(out, ref, ref.name + " 是过程，不能作为因子");
+				}
+				break;
+			case RefKind::ASSIGN:
+				if (!isVar) {
+					report(out, ref, "对于赋值，" + ref.name + "不是变量或参数");
+				}
+				break;
+			case RefKind::READ:
+				if (!isVar) {
+					report(out, ref, ref.name + " 不是变量，不能作为 read 的目标");
+				}
+				break;
+			case RefKind::CALL:
+				if (ty != SYMBOLTYPE::PROC) {
+					report(out, ref, SymbolError(SymErrType::TYPE_MISMATCH, ref.name).what());
+				}
+				else if (ref.arg_count != sym->getProcParamCount()) {
+					report(out, ref, "过程" + ref.name + "调用时参数个数不匹配，定义时参数个数为"
+						+ to_string(sym->getProcParamCount()) + "，调用时传入参数个数为" + to_string(ref.arg_count));
+				}
+				break;
+			}
+		}
+	}
+
+	static void report(vector<Diagnostic>& out, const SymRef& ref, const string& msg) {
+		Diagnostic d;
+		d.row = ref.row;
+		d.column = ref.column;
+		d.msg = msg;
+		out.push_back(d);
+	}
+};
@@ -6,32 +6,32 @@
 
 using namespace std;
 
-// ========== öٶ壨ǿö٣C++11+ ==========
-// 
+// ========== 枚举定义（强类型枚举，C++11+） ==========
+// 符号类型
 enum class SYMBOLTYPE {
-    Const,  // 
-    VAR,    // 
-    PARAM,  // ̲
-    PROC    // 
+    Const,  // 常量
+    VAR,    // 变量
+    PARAM,  // 过程参数
+    PROC    // 过程
 };
 
-// 
+// 语义错误类型
 enum class SymErrType {
-    DUP_DEF,        // ͬظ
-    UNDEF,          // δʶ
-    TYPE_MISMATCH,  // Ͳƥ
-    PARAM_MISMATCH  // ̲ƥ
+    DUP_DEF,        // 同层重复定义
+    UNDEF,          // 未定义标识符
+    TYPE_MISMATCH,  // 类型不匹配
+    PARAM_MISMATCH  // 过程参数个数不匹配
 };
 
-// 쳣C++쳣
+// 语义错误异常（C++异常处理）
 class SymbolError : public  runtime_error {
 public:
     SymbolError(SymErrType err_type, const  string& name)
         : runtime_error(generateMsg(err_type, name)),
-        err_type_(err_type), name_(name), line_(0) { // line_ʼδʼ
+        err_type_(err_type), name_(name), line_(0) { // 补充line_初始化，避免未初始化警告
     }
 
-    // ȡ
+    // 获取错误详情
     SymErrType getErrType() const { return err_type_; }
     string getName() const { return name_; }
     int getLine() const { return line_; }
@@ -41,21 +41,21 @@ private:
     string name_;
     int line_;
 
-    // ɴϢ
+    // 生成错误信息
     string generateMsg(SymErrType err_type, const  string& name) {
         string msg = "";
         switch (err_type) {
         case SymErrType::DUP_DEF:
-            msg += "ʶ\"" + name + "\"ڵǰظ";
+            msg += "标识符\"" + name + "\"在当前层重复定义";
             break;
         case SymErrType::UNDEF:
-            msg += "ʶ\"" + name + "\"δ";
+            msg += "标识符\"" + name + "\"未定义";
             break;
         case SymErrType::TYPE_MISMATCH:
-            msg += "ʶ\"" + name + "\"Ͳƥ";
+            msg += "标识符\"" + name + "\"类型不匹配";
             break;
         case SymErrType::PARAM_MISMATCH:
-            msg += "\"" + name + "\"òƥ";
+            msg += "过程\"" + name + "\"调用参数个数不匹配";
             break;
         }
         return msg;
@@ -64,50 +64,50 @@ private:
 
 class SymLayer;
 
-// ========== ࣨSymbol ==========
+// ========== 符号项类（Symbol） ==========
 class Symbol {
 
 public:
-    // ͨ
+    // 通用属性
     string name_;
     SYMBOLTYPE type_;
     int level_;
     Symbol* next_; 
 
-    // רԣ壬C++11+ַ֧ƽͣ
+    // 专属属性（共用体，C++11+支持非平凡类型）
     union Attr {
-        int const_val;                // ֵ
+        int const_val;                // 常量值
         struct VarAttr {
-			int offset;              // /ƫ
-			int value;			   // ֵ
+			int offset;              // 变量/参数偏移
+			int value;			   // 变量值
         } var_attr;             
-        struct ProcAttr {             // 
-            int param_count;// 
-            int var_count; // ֲ
-			int entry_addr;//pcodeڵַ
-			SymLayer* layer_ptr; // ̶ӦķŲָ루ѡڷʹڷţ
+        struct ProcAttr {             // 过程属性
+            int param_count;// 参数个数
+            int var_count; // 局部变量个数
+			int entry_addr;//pcode入口地址
+			SymLayer* layer_ptr; // 过程对应的符号层指针（可选，便于访问过程内符号）
         } proc_attr;
 
-        Attr() : const_val(0) {}      // 幹
+        Attr() : const_val(0) {}      // 共用体构造
         ~Attr() {}
     } attr_;
 
-    // 캯أ
+    // 构造函数（按符号类型重载）
     Symbol(const  string& name, SYMBOLTYPE type, int level)
         : name_(name), type_(type), level_(level), next_(nullptr) {
     }
 
-    // Ź
+    // 常量符号构造
     static  Symbol* createConst(const  string& name, int level, int val) {
         Symbol* sym = new Symbol(name, SYMBOLTYPE::Const, level);
         sym->attr_.const_val = val;
         return sym;
     }
 
-    // /Ź
+    // 变量/参数符号构造
     static  Symbol* createVarOrParam(const  string& name, SYMBOLTYPE type, int level, int offset , int value) {
         if (type != SYMBOLTYPE::VAR && type != SYMBOLTYPE::PARAM) {
-            throw  invalid_argument("ͱVARPARAM");
+            throw  invalid_argument("类型必须是VAR或PARAM");
         }
         Symbol* sym = new Symbol(name, type, level);
 		sym->attr_.var_attr.offset = offset;
@@ -115,7 +115,7 @@ public:
         return sym;
     }
 
-    // ̷Ź
+    // 过程符号构造
     static  Symbol* createProc(const  string& name, int level, int param_count, int entry_addr = -1) {
         Symbol* sym = new Symbol(name, SYMBOLTYPE::PROC, level);
         sym->attr_.proc_attr.param_count = param_count;
@@ -123,35 +123,35 @@ public:
         return sym;
     }
 
-    // ȡԣֻװԣ
+    // 获取属性（只读，封装性）
     string getName() const { return name_; }
     SYMBOLTYPE getType() const { return type_; }
     int getLevel() const { return level_; }
     int getConstVal() const {
         if (type_ != SYMBOLTYPE::Const) {
-            cerr << "󣺷 " << name_ << " ǳ޷ȡֵ" << endl;
-            return 0; // Ĭֵ
+            cerr << "错误：符号 " << name_ << " 不是常量，无法获取常量值" << endl;
+            return 0; // 返回默认值避免程序崩溃
         }
         return attr_.const_val;
     }
     int getOffset() const {
         if (type_ != SYMBOLTYPE::VAR && type_ != SYMBOLTYPE::PARAM) {
-            cerr << "󣺷 " << name_ << " Ǳ޷ȡƫ" << endl;
-            return 0; // Ĭֵ
+            cerr << "错误：符号 " << name_ << " 不是变量或参数，无法获取偏移量" << endl;
+            return 0; // 返回默认值避免程序崩溃
         }
 		return attr_.var_attr.offset;
     }
     int getProcParamCount() const {
         if (type_ != SYMBOLTYPE::PROC) {
-            cerr << "󣺷 " << name_ << " ṇ̀޷ȡ" << endl;
-            return 0; // Ĭֵ
+            cerr << "错误：符号 " << name_ << " 不是过程，无法获取参数个数" << endl;
+            return 0; // 返回默认值避免程序崩溃
         }
         return attr_.proc_attr.param_count;
     }
     int getProcEntryAddr() const {
         if (type_ != SYMBOLTYPE::PROC) {
-            cerr << "󣺷 " << name_ << " ṇ̀޷ȡڵַ" << endl;
-            return -1; // Ĭֵ
+            cerr << "错误：符号 " << name_ << " 不是过程，无法获取入口地址" << endl;
+            return -1; // 返回默认值避免程序崩溃
         }
         return attr_.proc_attr.entry_addr;
     }
@@ -163,60 +163,60 @@ public:
             return attr_.const_val;
         }
         else {
-            cerr << "󣺷 " << name_ << " Ͳֻ֧ȡֵ" << endl;
-            return 0; // Ĭֵ
+            cerr << "错误：符号 " << name_ << " 类型不支持获取值操作" << endl;
+            return 0; // 返回默认值避免程序崩溃
         }
     }
 
-    //ù̱
+    //设置过程变量个数
     void setProcVarCount(int var_count) {
         if (type_ != SYMBOLTYPE::PROC) {
-            cerr << "󣺷 " << name_ << " ṇ̀޷ñ" << endl;
+            cerr << "错误：符号 " << name_ << " 不是过程，无法设置变量个数" << endl;
             return;
         }
         attr_.proc_attr.var_count = var_count;
     }
 
-    // ùڵַPʱ
+    // 设置过程入口地址（P代码生成时回填）
     void setProcEntryAddr(int addr) {
         if (type_ != SYMBOLTYPE::PROC) {
-            cerr << "󣺷 " << name_ << " ṇ̀޷ڵַ" << endl;
+            cerr << "错误：符号 " << name_ << " 不是过程，无法设置入口地址" << endl;
             return;
         }
         attr_.proc_attr.entry_addr = addr;
     }
 
-    // ָ루ڷ
+    // 链表指针（层内符号链表）
     Symbol* getNext() const { return next_; }
     void setNext(Symbol* next) { next_ = next; }
 };
 
-// ========== űࣨSymLayer ==========
+// ========== 符号表层类（SymLayer） ==========
 class SymLayer {    
 
 public:
 
-    string layer_name_ = "";         //ǰĹ
-    int level_;               // 㼶
-    SymLayer* outer_;         // ָ루ָ룬SymbolTable
-    Symbol* sym_head_;        // ڷͷ
-	Symbol* sym_tail_;        // ڷβ
-    int var_offset_;          // ƫƼ
-    int param_count_;         // 
+    string layer_name_ = "";         //当前层的过程名
+    int level_;               // 层级
+    SymLayer* outer_;         // 外层指针（裸指针，由SymbolTable管理）
+    Symbol* sym_head_;        // 层内符号链表头
+	Symbol* sym_tail_;        // 层内符号链表尾
+    int var_offset_;          // 变量偏移计数器
+    int param_count_;         // 参数计数器
 
 
     SymLayer(int level, SymLayer* outer)
         : level_(level), outer_(outer),  var_offset_(0), param_count_(0), layer_name_("") {
-		sym_head_ = sym_tail_ = nullptr;// ʼΪ
+		sym_head_ = sym_tail_ = nullptr;// 初始化符号链表为空
     }
 
     ~SymLayer() {
-        // ٲڷ
+        // 销毁层内符号链表
         Symbol* cur = sym_head_;
         while (cur != nullptr) {
             Symbol* tmp = cur;
             cur = cur->getNext();
-            delete tmp;  // ͷŷŽڵ㣨ֶͷţӦcreateϵеnew
+            delete tmp;  // 释放符号节点（手动释放，对应create系列的new）
         }
     }
 
@@ -227,7 +227,7 @@ public:
         this->layer_name_ = layer_name;
     }
 
-    // ҲڷţLL(1)޻ݲң
+    // 查找层内符号（LL(1)无回溯查找）
     Symbol* findInLayer(const  string name) const {
         Symbol* cur = sym_head_;
         while (cur != nullptr) {
@@ -239,7 +239,7 @@ public:
         return nullptr;
     }
 
-    // ŵβ
+    // 插入符号到尾
     void insertSymbol(Symbol* sym) {
         if (sym == nullptr) return;
         
@@ -253,40 +253,40 @@ public:
 		}
     }
 
-    // Է
+    // 属性访问
     int getLevel()  { return level_; }
     SymLayer* getOuter()  { return outer_; }
     int getVarOffset()  { return var_offset_; }
     int getParamCount()  { return param_count_; }
 
-    // ƫ/
+    // 偏移量/参数计数自增
     int incVarOffset() { return var_offset_++; }
     int incParamCount() { return param_count_++; }
 
-    // ӡڷţԣ
+    // 打印层内符号（调试）
     void printLayer()  {
-        cout << "  㼶" << level_ << "" << endl;
+        cout << "  层级" << level_ << "：" << endl;
         if (sym_head_ == nullptr) {
-            cout << "    ޷" << endl;
+            cout << "    无符号" << endl;
             return;
         }
         Symbol* cur = sym_head_;
         while (cur != nullptr) {
-            cout << "    ƣ" << cur->getName() << " | ͣ";
+            cout << "    名称：" << cur->getName() << " | 类型：";
 
             SYMBOLTYPE ty = cur->getType();
             if (ty == SYMBOLTYPE::Const) {
-                cout << " | ֵ" << cur->getConstVal();
+                cout << "常量 | 值：" << cur->getConstVal();
             }
             else if (ty == SYMBOLTYPE::VAR) {
-                cout << " | ƫƣ" << cur->getOffset(); 
+                cout << "变量 | 偏移：" << cur->getOffset(); 
             }
             else if (ty == SYMBOLTYPE::PARAM) {
-                cout << " | ƫƣ" << cur->getOffset();
+                cout << "参数 | 偏移：" << cur->getOffset();
             }
             else if (ty == SYMBOLTYPE::PROC) {
-                cout << " | " << cur->getProcParamCount()
-                    << " | ڵַ" << cur->getProcEntryAddr();
+                cout << "过程 | 参数数：" << cur->getProcParamCount()
+                    << " | 入口地址：" << cur->getProcEntryAddr();
             }
 
             cout << endl;
@@ -295,31 +295,31 @@ public:
     }
 };
 
-// ========== űࣨSymbolTable ==========
+// ========== 符号表管理器类（SymbolTable） ==========
 class SymbolTable {
 public:
-	SymLayer* first_layer_ ;//Ųָ
+	SymLayer* first_layer_ ;//最外层符号层指针
 
-    SymLayer* current_layer_;// ǰŲָ
+    SymLayer* current_layer_;// 当前符号层指针
 
     SymbolTable() :current_layer_(nullptr) {
         first_layer_=current_layer_ = new SymLayer(0, nullptr);
     }
 
     ~SymbolTable() {
-        // ֶݹͷзŲ㣨ָԶͷţ
+        // 手动递归释放所有符号层（替代智能指针自动释放）
         releaseAllLayers(current_layer_);
     }
 
 
 
-    // ========== ŲAPI ==========
+    // ========== 符号插入API ==========
     void insertConst(const  string& name, int val) {
-        // ظ
+        // 检查重复定义
         if (current_layer_->findInLayer(name) != nullptr) {
             throw SymbolError(SymErrType::DUP_DEF, name);
         }
-        // 볣
+        // 创建并插入常量符号
         Symbol* sym = Symbol::createConst(name, current_layer_->getLevel(), val);
         current_layer_->insertSymbol(sym);
     }
@@ -327,7 +327,7 @@ public:
         if (current_layer_->findInLayer(name) != nullptr) {
             throw SymbolError(SymErrType::DUP_DEF, name);
         }
-        // Զƫ
+        // 自动分配偏移量
         int offset = current_layer_->incVarOffset();
         Symbol* sym = Symbol::createVarOrParam(name, SYMBOLTYPE::VAR, current_layer_->getLevel(), offset ,val);
         current_layer_->insertSymbol(sym);
@@ -336,9 +336,9 @@ public:
         if (current_layer_->findInLayer(name) != nullptr) {
             throw SymbolError(SymErrType::DUP_DEF, name);
         }
-        // ƫƴ0ʼ
+        // 参数偏移从0开始
         int offset = current_layer_->incParamCount();
-        // ƫƴӲʼ
+        // 变量偏移从参数个数开始
         current_layer_->incVarOffset();  // var_offset = param_count
         Symbol* sym = Symbol::createVarOrParam(name, SYMBOLTYPE::PARAM, current_layer_->getLevel(), offset ,val);
         current_layer_->insertSymbol(sym);
@@ -355,19 +355,19 @@ public:
 
 
 
-    // ========== ŲAPILL(1)ķ ==========
-    // ȫֲңط+  , = ò - 
+    // ========== 符号查找API（适配LL(1)文法） ==========
+    // 全局查找，返回符号+层差  ,层差 = 调用层 - 定义层
     Symbol* findGlobal(const  string name, int& level_diff ,int used_level = 0) {
         SymLayer* cur_layer = current_layer_; 
 		SymLayer* layer = first_layer_;
 		vector<SymLayer*> layer_stack;
 		layer_stack.push_back(first_layer_);
-		//㿪ʼ
+		//从最外层开始查找
         while (!layer_stack.empty())
         {
 			layer = layer_stack.front();
 			layer_stack.erase(layer_stack.begin());
-			// ҵǰڷ
+			// 查找当前层内符号
 			Symbol* sym = layer->sym_head_;
             while (sym != nullptr) {
                 if (sym->getName() == name) {
@@ -382,19 +382,43 @@ public:
             }
 
         }
-        // δҵ쳣
+        // 未找到则抛异常
         throw SymbolError(SymErrType::UNDEF, name);
     }
 
-    //ѰҵǰһĶ
+    // 按静态作用域查找：从layer逐层向外，返回最近的可见符号，未找到返回nullptr（只读，可并发调用）
+    Symbol* findVisible(SymLayer* layer, const string& name) const {
+        while (layer != nullptr) {
+            Symbol* sym = layer->findInLayer(name);
+            if (sym != nullptr) {
+                return sym;
+            }
+            layer = layer->outer_;
+        }
+        return nullptr;
+    }
+    // 同上，level为找到符号的那一层的层号
+    Symbol* findVisible(SymLayer* layer, const string& name, int& level) const {
+        while (layer != nullptr) {
+            Symbol* sym = layer->findInLayer(name);
+            if (sym != nullptr) {
+                level = layer->getLevel();
+                return sym;
+            }
+            layer = layer->outer_;
+        }
+        return nullptr;
+    }
+
+    //寻找当前过程在上一层的定义
     Symbol* findProc() {
         Symbol* sym = findGlobal(current_layer_->getLayerName(), *(new int));
         return sym;
     }
 
-    //ڵַҹ̷
+    //根据入口地址查找过程符号
     SymLayer* findProcByEntry(int entry_addr) {
-        // 㿪ʼ㼶/
+        // 从最外层开始层级遍历（广度优先/层序）
         vector<SymLayer*> layers;
         layers.push_back(first_layer_);
 
@@ -405,11 +429,11 @@ public:
 
             Symbol* sym = layer->sym_head_;
             while (sym != nullptr) {
-                // ҵڵַƥ䣬ظù̶Ӧڲ SymLayer ָ루Ϊ nullptr
+                // 找到过程且入口地址匹配，返回该过程对应的内层 SymLayer 指针（可能为 nullptr）
                 if (sym->getType() == SYMBOLTYPE::PROC && sym->getProcEntryAddr() == entry_addr) {
                     return sym->attr_.proc_attr.layer_ptr;
                 }
-                // ǹڲ㣬ڲ
+                // 若是过程且有内层，则把内层加入遍历队列
                 if (sym->getType() == SYMBOLTYPE::PROC && sym->attr_.proc_attr.layer_ptr != nullptr) {
                     layers.push_back(sym->attr_.proc_attr.layer_ptr);
                 }
@@ -417,14 +441,14 @@ public:
             }
         }
 
-        // δҵ򷵻 nullptr÷ɸҪ״
-		cerr << "棺δҵڵַΪ " << entry_addr << " Ĺ̷" << endl;
+        // 未找到则返回 nullptr（调用方可根据需要抛错或处理）
+		cerr << "警告：未找到入口地址为 " << entry_addr << " 的过程符号" << endl;
         return nullptr;
     }
 
 
-    // ========== <proc>ڲ/л ==========
-    // ڲ
+    // ========== 作用域管理（适配<proc>的内层/外层切换） ==========
+    // 进入过程内层
     SymLayer* enterProcLayer() {
 
         SymLayer* new_layer = new SymLayer(current_layer_->getLevel()+1, current_layer_);
@@ -432,67 +456,67 @@ public:
         return current_layer_;
     }
 
-    // ˳ڲ
+    // 退出过程内层
     void exitProcLayer() {
         if (current_layer_->getLevel() == 0) {
-            throw  runtime_error("޷˳ȫֲ");
+            throw  runtime_error("无法退出全局层");
         }
 
         SymLayer* outer = current_layer_->getOuter();
         SymLayer* current = current_layer_;
-        current_layer_ = outer;  // л
+        current_layer_ = outer;  // 切换到外层
 
     }
 
 
-    // ========== API ==========
+    // ========== 辅助API ==========
 
-    //һ
+    //回填变量个数（过程名在上一级）
     void fillProcVarCount(int var_count) {
         
 		Symbol* cur_sym = findProc();
-        // 
+        // 回填变量个数
         cur_sym->setProcVarCount(var_count);
     }
 
-    // ڱڣӺǰδڵַĹ̷ţڹǶ׽
+    // 仅在本层内，从后向前查找未回填入口地址的过程符号（用于过程嵌套结束回填）
     string findNearestUnfilledProc() {
-        // 1. ޶ǰ㣬
+        // 1. 仅限定当前层，不向外层遍历
         SymLayer* current_only_layer = current_layer_;
         if (current_only_layer == nullptr) {
-            throw runtime_error("ǰű㲻ڣ޷ҹ̷");
+            throw runtime_error("当前符号表层不存在，无法查找过程符号");
         }
 
         Symbol* cur_sym = current_only_layer->sym_head_;
-        // 2. ȱβȡβڵ㣬ʵִӺǰҵĻ
-        // ⴦ǰ޷ţΪգ
+        // 2. 先遍历到链表尾部（获取尾节点，实现从后向前查找的基础）
+        // 特殊处理：当前层无符号（链表为空）
         if (cur_sym == nullptr) {
-            throw runtime_error("ǰκηţδҵҪĹ̷");
+            throw runtime_error("当前层无任何符号，未找到需要回填的过程符号");
         }
 
-        // ڱڵǰʵִӺǰ
+        // 用于保存链表节点的前驱，实现从后向前遍历
         vector<Symbol*> symbol_list;
-        // ȽǰзŽڵvector˳ͷβ洢
+        // 先将当前层所有符号节点存入vector，按链表顺序（头→尾）存储
         while (cur_sym != nullptr) {
             symbol_list.push_back(cur_sym);
             cur_sym = cur_sym->getNext();
         }
 
-        // 3. vectorβͷӺǰң
+        // 3. 逆序遍历vector（即链表的尾→头，从后向前查找）
         for (auto it = symbol_list.rbegin(); it != symbol_list.rend(); ++it) {
             Symbol* sym = *it;
-            // ɸѡδڵַĹ̷
+            // 筛选未回填入口地址的过程符号
             if (sym->getType() == SYMBOLTYPE::PROC &&
                 sym->getProcEntryAddr() == -1) {
                 return sym->getName();
             }
         }
 
-        // 4. δҵ׳쳣
-        throw runtime_error("ǰδҵҪڵַĹ̷");
+        // 4. 未找到则抛出异常
+        throw runtime_error("当前层内未找到需要回填入口地址的过程符号");
     }
     
-    // ڵַǶ׽
+    // 回填过程入口地址，过程嵌套结束回填
     void fillProcEntry(int entry_addr) {
 
         int level_diff = 0;
@@ -505,7 +529,34 @@ public:
     }
 
 
-    // ̲ƥ
+    // 代码重排后重定位所有过程入口地址，newAddr[旧地址]为-1表示过程已被删除
+    // 返回被删除的过程个数
+    int relocateProcEntries(const vector<int>& newAddr) {
+        int removed = 0;
+        vector<SymLayer*> layers;
+        layers.push_back(first_layer_);
+        while (!layers.empty()) {
+            SymLayer* layer = layers.front();
+            layers.erase(layers.begin());
+            if (layer == nullptr) continue;
+
+            Symbol* sym = layer->sym_head_;
+            while (sym != nullptr) {
+                if (sym->getType() == SYMBOLTYPE::PROC) {
+                    int entry = sym->getProcEntryAddr();
+                    if (entry >= 0 && entry < (int)newAddr.size()) {
+                        sym->setProcEntryAddr(newAddr[entry]);
+                        if (newAddr[entry] < 0) removed++;
+                    }
+                    layers.push_back(sym->attr_.proc_attr.layer_ptr);
+                }
+                sym = sym->getNext();
+            }
+        }
+        return removed;
+    }
+
+    // 检查过程参数个数匹配
     void checkParamCount(string proc_name, int arg_count) {
         int level_diff = 0;
         Symbol* proc_sym = findGlobal(proc_name, level_diff);
@@ -517,38 +568,38 @@ public:
         }
     }
 
-    // ӡűԣ
+    // 打印整个符号表（调试）
     void printTable() const {
-        cout << "\n===== PL/0 ű=====" << endl;
-        // в㣨ӵǰ㵽ȫֲ㣩
+        cout << "\n===== PL/0 符号表=====" << endl;
+        // 遍历所有层（从当前层到全局层）
         SymLayer* cur_layer;
-		//㿪ʼ
+		//从最外层开始
 		vector<SymLayer*> layers;
 		layers.push_back(first_layer_);
-		//㼶ӡ
+		//层级遍历打印
         while (!layers.empty()) {
             cur_layer = layers.front();
             layers.erase(layers.begin());
             if (cur_layer != nullptr) {
-				cout << "========̣" << cur_layer->getLayerName() << " | 㼶" << cur_layer->getLevel() << "========" << endl;
+				cout << "========过程：" << cur_layer->getLayerName() << " | 层级" << cur_layer->getLevel() << "========" << endl;
 				Symbol* sym = cur_layer->sym_head_;
-				// ӡϢ
+				// 打印层信息
                 while (sym != nullptr) {
-					// ӡϢ
+					// 打印符号信息
                     SYMBOLTYPE ty = sym->getType();
                     if (ty == SYMBOLTYPE::Const) {
-                        cout << " | ֵ" << sym->getConstVal();
+                        cout << "常量 | 值：" << sym->getConstVal();
                     }
                     else if (ty == SYMBOLTYPE::VAR) {
-                        cout << ""<<sym->getName() <<" | ƫƣ" << sym->getOffset(); // ԭVAR/PARAMӡ
+                        cout << "变量"<<sym->getName() <<" | 偏移：" << sym->getOffset(); // 修正原代码的VAR/PARAM打印混淆
                     }
                     else if (ty == SYMBOLTYPE::PARAM) {
-                        cout << "" << sym->getName() << " | ƫƣ" << sym->getOffset();
+                        cout << "参数" << sym->getName() << " | 偏移：" << sym->getOffset();
                     }
                     else if (ty == SYMBOLTYPE::PROC) {
-                        cout << " " << sym->getName() << " | " << sym->getProcParamCount()
-                            << " | ڵַ" << sym->getProcEntryAddr();
-						layers.push_back(sym->attr_.proc_attr.layer_ptr);//̲㣬ӡ
+                        cout << "过程 " << sym->getName() << " | 参数数：" << sym->getProcParamCount()
+                            << " | 入口地址：" << sym->getProcEntryAddr();
+						layers.push_back(sym->attr_.proc_attr.layer_ptr);//加入过程层，后续打印
                     }
                     cout << endl;
 					sym = sym->getNext();
@@ -563,12 +614,12 @@ public:
 
 private:
 
-    // ݹͷзŲ㣨
+    // 递归释放所有符号层（辅助析构函数）
     void releaseAllLayers(SymLayer* layer) {
         if (layer == nullptr) return;
-        // ȵݹͷ㣨ָ룩
+        // 先递归释放外层（避免悬挂指针）
         releaseAllLayers(layer->getOuter());
-        // ͷŵǰ㣨SymLayerԶͷڲ
+        // 释放当前层（SymLayer析构函数会自动释放内部符号链表）
         delete layer;
     }
 };
\ No newline at end of file
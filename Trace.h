@@ -0,0 +1,127 @@
+/*
+二进制执行轨迹
+每步只记录地址和该步写入的栈单元，过程调用/返回记录为标记，经大缓冲区成块写出
+trace2txt.py 可将其还原为 pcode_output.txt 文本格式，供 main.py 展示
+*/
+
+#pragma once
+#include<fstream>
+#include<iostream>
+#include<string>
+#include<vector>
+#include<cstdint>
+#include<cstring>
+#include"DebugInfo.h"
+
+using namespace std;
+
+/*文件格式（小端）
+头部：magic "PL0T" | version(u32)
+      指令条数(u32) | 每条：助记符(字符串) L(i32) A(i32)，即文本轨迹中显示的形式
+      过程个数(u32) | 每个过程：名字(字符串) ID个数(u32) ID名字*ID个数
+      字符串：长度(u32) + 字节
+记录：标记(u8) + 变长整数（LEB128，有符号数先做zigzag）
+  STEP  pc                         执行一条指令
+  CALL  过程下标 活动记录基址       进入过程（文本中的 newAc:name）
+  BACK  层                         返回（文本中的 back 层）
+  STACK 栈顶 写入个数 {下标 值}*    该步执行后的栈顶和该步写入的单元；
+                                   此前有未记录的步（-trace-every、-trace-proc）时为[0, 栈顶)全部单元
+*/
+class BinTrace {
+public:
+	static const uint32_t VERSION = 1;
+	enum Tag : uint8_t { STEP = 1, CALL = 2, BACK = 3, STACK = 4 };
+
+	bool open(const string& file, const vector<string>& insNames, const vector<pair<int, int>>& insLA,
+		const DebugInfo& dbg) {
+		out.open(file, ios::out | ios::binary);
+		if (!out.is_open()) {
+			cerr << "无法打开轨迹文件: " << file << endl;
+			return false;
+		}
+		buf.clear();
+		buf.reserve(BUF_SIZE + 4096);
+
+		buf.append("PL0T", 4);
+		putU32(VERSION);
+		putU32(insNames.size());
+		for (size_t i = 0; i < insNames.size(); i++) {
+			putStr(insNames[i]);
+			putU32((uint32_t)insLA[i].first);
+			putU32((uint32_t)insLA[i].second);
+		}
+		putU32(dbg.procs.size());
+		for (const ProcInfo& p : dbg.procs) {
+			putStr(p.name);
+			putU32(p.id_count);
+			for (const string& id : p.ids) putStr(id);
+		}
+		return true;
+	}
+
+	void step(int pc) {
+		buf.push_back((char)STEP);
+		putVar(pc);
+		check();
+	}
+	void call(int proc, int base) {
+		buf.push_back((char)CALL);
+		putVar(proc);
+		putVar(base);
+	}
+	void back(int layer) {
+		buf.push_back((char)BACK);
+		putVar(layer);
+	}
+
+	// 记录栈顶和slots中各单元的值，slots由解释器按指令给出，不与上一次记录比较
+	void stack(const vector<int>& st, int top, const vector<int>& slots) {
+		buf.push_back((char)STACK);
+		putVar(top);
+		putVar(slots.size());
+		for (int i : slots) {
+			putVar(i);
+			putVar(zigzag(st[i]));
+		}
+	}
+
+	void close() {
+		if (!out.is_open()) return;
+		out.write(buf.data(), buf.size());
+		buf.clear();
+		out.close();
+	}
+
+private:
+	static const size_t BUF_SIZE = 1 << 20; // 缓冲区满1MB成块写出
+
+	ofstream out;
+	string buf;
+
+	void check() {
+		if (buf.size() >= BUF_SIZE) {
+			out.write(buf.data(), buf.size());
+			buf.clear();
+		}
+	}
+
+	static uint32_t zigzag(int32_t v) {
+		return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+	}
+	void putVar(uint32_t v) {
+		while (v >= 0x80) {
+			buf.push_back((char)(v | 0x80));
+			v >>= 7;
+		}
+		buf.push_back((char)v);
+	}
+	void putU32(uint32_t v) {
+		char b[4];
+		memcpy(b, &v, 4);
+		buf.append(b, 4);
+	}
+	void putStr(const string& s) {
+		putU32(s.size());
+		buf.append(s);
+	}
+};
@@ -0,0 +1,103 @@
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# -------------------------- 基准测试 --------------------------
+# 用编译器的 -stats 统计对 bench/ 下的各程序计时，每种执行方式取多次运行的最短用时。
+# 程序 X.txt 的输入放在 X.in（没有则输入为空）。
+# 可给出多个编译器（--pl0 旧版 --pl0 新版）对比改动前后的用时。
+# 程序复制为临时目录中的 pascal.txt 后编译执行，中间文件不写入仓库。
+
+TIME_RE = re.compile(r'用时 ([0-9.eE+-]+) 秒')
+STEPS_RE = re.compile(r'执行(?:寄存器)?指令 (\d+) 条')
+
+DEFAULT_MODES = ['-dispatch=switch', '-dispatch=threaded', '-vm=reg', '-vm=jit', '-vm=tier']
+
+
+def decode(data):
+    """编译器输出自动适配utf-8/gbk编码"""
+    for enc in ('utf-8', 'gbk'):
+        try:
+            return data.decode(enc)
+        except UnicodeDecodeError:
+            continue
+    return data.decode('utf-8', errors='replace')
+
+
+def run_once(pl0, input_file, mode, work):
+    """编译并执行一次work中的pascal.txt，返回 (用时秒, 指令条数, 输出)，未得到用时返回 None"""
+    cmd = [pl0, '-stats']
+    if input_file:
+        cmd.append('-in=' + input_file)
+    cmd += mode.split()
+    proc = subprocess.run(cmd, cwd=work, stdin=subprocess.DEVNULL,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    text = decode(proc.stdout)
+    m = TIME_RE.search(text)
+    if proc.returncode != 0 or not m:
+        return None, None, text
+    steps = STEPS_RE.search(text)
+    return float(m.group(1)), int(steps.group(1)) if steps else None, text
+
+
+def bench(pl0, src, input_file, mode, repeat, work):
+    """多次运行取最短用时"""
+    shutil.copyfile(src, os.path.join(work, 'pascal.txt'))
+    best, steps = None, None
+    for _ in range(repeat):
+        sec, n, text = run_once(pl0, input_file, mode, work)
+        if sec is None:
+            print(f"运行失败：{os.path.basename(src)} [{mode}]\n{text}", file=sys.stderr)
+            return None, None
+        best = sec if best is None else min(best, sec)
+        steps = n
+    return best, steps
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='对 bench/ 下的程序按各执行方式计时')
+    parser.add_argument('programs', nargs='*', help='基准程序，默认 bench/*.txt')
+    parser.add_argument('--pl0', action='append', help='编译器可执行文件，可多次给出以对比，默认 ./pl0')
+    parser.add_argument('-m', '--mode', action='append', help='执行方式选项，写作 -m=-vm=reg，可多次给出，默认全部')
+    parser.add_argument('-r', '--repeat', type=int, default=7, help='每项运行次数，取最短用时，默认7')
+    args = parser.parse_args()
+
+    pl0s = [os.path.abspath(p) for p in (args.pl0 or [os.path.join(here, 'pl0')])]
+    for p in pl0s:
+        if not os.path.isfile(p):
+            print(f"找不到编译器：{p}（先用 g++ -std=c++17 -O2 main.cpp -o pl0 编译）", file=sys.stderr)
+            return 1
+    modes = args.mode or DEFAULT_MODES
+    programs = args.programs
+    if not programs:
+        bench_dir = os.path.join(here, 'bench')
+        programs = sorted(os.path.join(bench_dir, f) for f in os.listdir(bench_dir) if f.endswith('.txt'))
+
+    work = tempfile.mkdtemp(prefix='pl0bench')
+    try:
+        print(f"{'程序':<10}{'执行方式':<22}{'指令条数':>12}" + ''.join(f"{os.path.basename(p):>12}" for p in pl0s))
+        for prog in programs:
+            src = os.path.abspath(prog)
+            input_file = os.path.splitext(src)[0] + '.in'
+            if not os.path.isfile(input_file):
+                input_file = None
+            name = os.path.splitext(os.path.basename(src))[0]
+            for mode in modes:
+                cells, count = [], None
+                for p in pl0s:
+                    sec, n = bench(p, src, input_file, mode, args.repeat, work)
+                    cells.append('失败' if sec is None else f"{sec:.4f}")
+                    count = count or n
+                print(f"{name:<10}{mode:<22}{count if count else '-':>12}" + ''.join(f"{c:>12}" for c in cells))
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
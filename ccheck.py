@@ -0,0 +1,116 @@
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# -------------------------- C 后端对照测试 --------------------------
+# 对每个样例程序：编译器 -emit-c 输出C源文件并解释执行，用 cc 编译该C文件后运行，
+# 比较两者的 write 输出、是否正常结束（"程序结束"）及是否以运行时错误退出。
+# 程序 X.txt 的输入取自 X.in，没有则用 --input 给出的内容。
+# 运行时错误的详细信息（如输入出错的行列）两者不同，只比较是否出错。
+
+OUT_RE = re.compile(r'^输出: (-?\d+)$')
+ERR_PREFIX = '运行时错误：'
+
+
+def decode(data):
+    """输出自动适配utf-8/gbk编码"""
+    for enc in ('utf-8', 'gbk'):
+        try:
+            return data.decode(enc)
+        except UnicodeDecodeError:
+            continue
+    return data.decode('utf-8', errors='replace')
+
+
+def summarize(stdout, stderr, code):
+    """(输出值列表, 是否正常结束, 是否运行时错误, 退出码是否非零)"""
+    values, finished = [], False
+    for line in decode(stdout).splitlines():
+        line = line.strip()
+        m = OUT_RE.match(line)
+        if m:
+            values.append(int(m.group(1)))
+        elif line == '程序结束':
+            finished = True
+    failed = ERR_PREFIX in decode(stdout) + decode(stderr)
+    return values, finished, failed, code != 0
+
+
+def check(pl0, cc, cflags, vm_opts, src, data, work):
+    """对照一个程序，返回差异说明，一致时返回空串"""
+    shutil.copyfile(src, os.path.join(work, 'pascal.txt'))
+    for f in ('prog.c', 'prog'):
+        if os.path.exists(os.path.join(work, f)):
+            os.remove(os.path.join(work, f))
+
+    interp = subprocess.run([pl0, '-emit-c=prog.c', '-in=-'] + vm_opts, cwd=work, input=data,
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    if not os.path.exists(os.path.join(work, 'prog.c')):
+        return '编译器未输出C源文件\n' + decode(interp.stdout + interp.stderr)
+    build = subprocess.run([cc] + cflags + ['prog.c', '-o', 'prog'], cwd=work,
+                           stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    if build.returncode != 0:
+        return 'C编译失败\n' + decode(build.stdout)
+    native = subprocess.run([os.path.join(work, 'prog')], cwd=work, input=data,
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+
+    a = summarize(interp.stdout, interp.stderr, interp.returncode)
+    b = summarize(native.stdout, native.stderr, native.returncode)
+    if a == b:
+        return ''
+    names = ('输出', '正常结束', '运行时错误', '退出码非零')
+    diff = [f"  {n}：解释器 {x}，C {y}" for n, x, y in zip(names, a, b) if x != y]
+    return '\n'.join(diff)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='C 后端输出与解释器输出对照')
+    parser.add_argument('programs', nargs='*', help='PL/0 程序，默认 pascal.txt 和 bench/*.txt')
+    parser.add_argument('--pl0', default=os.path.join(here, 'pl0'), help='编译器可执行文件，默认 ./pl0')
+    parser.add_argument('--cc', default='cc', help='C编译器，默认 cc')
+    parser.add_argument('--cflags', default='-O2', help='C编译选项，默认 -O2')
+    parser.add_argument('--vm', default='', help='解释器选项（如 -vm=reg），默认栈式解释器')
+    parser.add_argument('--input', default='3 4\n', help='没有 .in 文件时的输入，默认 "3 4"')
+    args = parser.parse_args()
+
+    pl0 = os.path.abspath(args.pl0)
+    if not os.path.isfile(pl0):
+        print(f"找不到编译器：{pl0}（先用 g++ -std=c++17 -O2 main.cpp -o pl0 编译）", file=sys.stderr)
+        return 1
+    programs = args.programs
+    if not programs:
+        bench_dir = os.path.join(here, 'bench')
+        programs = [os.path.join(here, 'pascal.txt')] + sorted(
+            os.path.join(bench_dir, f) for f in os.listdir(bench_dir) if f.endswith('.txt'))
+
+    work = tempfile.mkdtemp(prefix='pl0c')
+    failures = 0
+    try:
+        for prog in programs:
+            src = os.path.abspath(prog)
+            in_file = os.path.splitext(src)[0] + '.in'
+            if os.path.isfile(in_file):
+                with open(in_file, 'rb') as f:
+                    data = f.read()
+            else:
+                data = args.input.encode()
+            diff = check(pl0, args.cc, args.cflags.split(), args.vm.split(), src, data, work)
+            name = os.path.basename(prog)
+            if diff:
+                failures += 1
+                print(f"不一致  {name}\n{diff}")
+            else:
+                print(f"一致    {name}")
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+    print(f"共 {len(programs)} 个程序，{failures} 个不一致")
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,37 +1,170 @@
 #pragma once
 #include<string>
+#include<iostream>
+#include<cstdlib>
+#include<algorithm>
 #include<unordered_map>
 #include<unordered_set>
 using namespace std;
 
 bool panic_mode = false;
 bool rectify_mode = true;
-// ö,ս
+bool fold_mode = true;//常量折叠
+bool dce_mode = true;//死代码消除
+bool peephole_mode = true;//窥孔优化
+unordered_set<string> peephole_off;//关闭的窥孔规则名
+bool stats_mode = false;//解释执行结束后输出执行统计
+bool threaded_mode = false;//解释器使用直接线索化分派（-dispatch=threaded，编译器不支持时为switch）
+bool regvm_mode = false;//翻译为寄存器代码后执行
+bool jit_mode = false;//编译为x86-64机器码后执行（其他平台改用解释器）
+bool tier_mode = false;//分层执行：先解释，调用或循环次数超过阈值的过程改用机器码
+int tier_call = 1000;//过程被调用该次数后，之后的调用改用机器码
+int tier_loop = 10000;//循环回边执行该次数后，当前活动记录在循环头转入机器码（OSR）
+string emit_c = "";//同时翻译为C源文件（-emit-c=文件），用系统C编译器编译为本机程序
+bool super_mode = true;//超级指令融合
+string super_profile = "";//超级指令剖析文件（seqmine.py生成），为空时启用全部超级指令
+int super_top = 0;//只启用前N种超级指令，0为不限
+int stack_size = 1 << 20;//解释器数据栈单元数，启动时一次分配
+bool trace_mode = false;//输出每步执行轨迹到pcode_output.txt（供main.py展示）
+bool trace_binary = false;//执行轨迹以二进制增量格式写入pcode_trace.bin，用trace2txt.py还原
+int trace_every = 1;//每隔N步记录一步
+int trace_ring = 0;//大于0时只在内存中保留最近N步，结束或出错时写出（文本格式）
+string trace_proc = "";//只在该过程（含其调用的过程）执行期间记录
+string out_file = "";//write 输出文件（可为命名管道），为空时输出到屏幕
+int out_flush = 4096;//write 输出缓冲区达到该字节数时写出，0为每次写出
+string in_file = "";//read 输入文件，为空时交互读标准输入，"-"为成块读标准输入
+bool profile_mode = false;//执行剖析，报告写入pcode_profile.txt，折叠调用栈写入pcode_profile.folded
+string profile_src = "";//剖析时按行标注的源文件（结果写入pcode_profile_src.txt），为空时为 pascal.txt
+
+/*
+解释器选项，编译器 main 与独立虚拟机 pl0vm 共用，识别时返回true
+-stats 输出执行统计；-dispatch=switch|threaded 选择分派方式；-vm=stack|reg|jit|tier 选择栈式、寄存器虚拟机、JIT或分层执行
+-tier-call=<N> 分层执行的过程调用阈值；-tier-loop=<N> 循环回边阈值
+-stack=<单元数> 数据栈大小；-trace 输出执行轨迹，-trace=bin 输出二进制轨迹
+-trace-every=<N> 每N步记录一步；-trace-ring=<N> 只保留最近N步，结束或出错时输出；-trace-proc=<过程名> 只记录该过程执行期间
+-out=<文件> write 输出写到文件（可为命名管道）；-out-flush=<字节数> 输出缓冲区写出阈值，0为每次写出
+-in=<文件> read 从文件读取整数（空白分隔），-in=- 从标准输入成块读取
+-profile 按过程、操作码、指令、源码行统计执行次数和时间（只用栈式解释器）；-profile-src=<文件> 按行标注的源文件
+*/
+bool vmOption(const string& arg) {
+	if (arg == "-stats") {
+		stats_mode = true;
+	}
+	else if (arg == "-dispatch=switch") {
+		threaded_mode = false;
+	}
+	else if (arg == "-dispatch=threaded") {
+		threaded_mode = true;
+	}
+	else if (arg == "-vm=reg") {
+		regvm_mode = true;
+		jit_mode = false;
+		tier_mode = false;
+	}
+	else if (arg == "-vm=jit") {
+		jit_mode = true;
+		regvm_mode = false;
+		tier_mode = false;
+	}
+	else if (arg == "-vm=tier") {
+		tier_mode = true;
+		regvm_mode = false;
+		jit_mode = false;
+	}
+	else if (arg == "-vm=stack") {
+		regvm_mode = false;
+		jit_mode = false;
+		tier_mode = false;
+	}
+	else if (arg.rfind("-tier-call=", 0) == 0) {
+		tier_call = max(1, atoi(arg.c_str() + 11));
+	}
+	else if (arg.rfind("-tier-loop=", 0) == 0) {
+		tier_loop = max(1, atoi(arg.c_str() + 11));
+	}
+	else if (arg.rfind("-stack=", 0) == 0) {
+		stack_size = atoi(arg.c_str() + 7);
+		if (stack_size < 64) stack_size = 64;
+	}
+	else if (arg == "-trace") {
+		trace_mode = true;
+	}
+	else if (arg == "-trace=bin") {
+		trace_mode = true;
+		trace_binary = true;
+	}
+	else if (arg.rfind("-trace-every=", 0) == 0) {
+		trace_mode = true;
+		trace_every = max(1, atoi(arg.c_str() + 13));
+	}
+	else if (arg.rfind("-trace-ring=", 0) == 0) {
+		trace_mode = true;
+		trace_ring = max(1, atoi(arg.c_str() + 12));
+	}
+	else if (arg.rfind("-trace-proc=", 0) == 0) {
+		trace_mode = true;
+		trace_proc = arg.substr(12);
+	}
+	else if (arg.rfind("-out=", 0) == 0) {
+		out_file = arg.substr(5);
+	}
+	else if (arg.rfind("-out-flush=", 0) == 0) {
+		out_flush = max(0, atoi(arg.c_str() + 11));
+	}
+	else if (arg.rfind("-in=", 0) == 0) {
+		in_file = arg.substr(4);
+	}
+	else if (arg == "-profile") {
+		profile_mode = true;
+	}
+	else if (arg.rfind("-profile-src=", 0) == 0) {
+		profile_mode = true;
+		profile_src = arg.substr(13);
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+// 全部选项识别后处理互相冲突的解释器选项
+void vmOptionsDone() {
+	if (profile_mode && trace_mode) {
+		cerr << "剖析与跟踪不能同时使用，忽略 -profile" << endl;
+		profile_mode = false;
+	}
+	if (profile_mode && (regvm_mode || jit_mode || tier_mode)) {
+		cerr << "剖析只支持栈式解释器，忽略 -vm 选项" << endl;
+		regvm_mode = jit_mode = tier_mode = false;
+	}
+}
+
+// 单词类型枚举,终结符
 enum class TokenType {
-	// ؼ֣15ϸӦ BNF еı֣
+	// 关键字（共15个，严格对应 BNF 中的保留字）
 	PROGRAM, CONST, VAR, PROCEDURE, CALL,
 	BEGIN, END, IF, THEN, ELSE,
 	WHILE, DO, ODD, READ, WRITE,
 
-	// ʶͳֵ Token
-	IDENTIFIER,  //  summax<id>
-	INTEGER,     //  10050<integer>
-
-	// 3࣬Ӧ BNF  <aop><mop><lop>
-	AOP,  // ӷ+-
-	MOP,  // ˷*/
-	LOP,  // ϵ=<><<=>>=
-
-	// 6Ӧ BNF еķָţ
-	SEMICOLON,  // ; /˵
-	COMMA,      // , ʶ/ָ
-	LPAREN,     // ( /ʽͷ
-	RPAREN,     // ) /ʽβ
-	COLONEQUAL, // := ֵţ<statement> еĸֵ䣩
-
-	// 
-	EOF_TOKEN,  // ļ
-	ERROR       // Чַ
+	// 标识符和常量（带值的 Token）
+	IDENTIFIER,  // 如 sum、max（<id>）
+	INTEGER,     // 如 100、50（<integer>）
+
+	// 运算符（3类，对应 BNF 的 <aop>、<mop>、<lop>）
+	AOP,  // 加法运算符：+、-
+	MOP,  // 乘法运算符：*、/
+	LOP,  // 关系运算符：=、<>、<、<=、>、>=
+
+	// 界符（6个，对应 BNF 中的分隔符号）
+	SEMICOLON,  // ; （语句/说明结束）
+	COMMA,      // , （多个标识符/常量分隔）
+	LPAREN,     // ( （参数/表达式开头）
+	RPAREN,     // ) （参数/表达式结尾）
+	COLONEQUAL, // := （赋值符号，<statement> 中的赋值语句）
+
+	// 特殊标记
+	EOF_TOKEN,  // 文件结束标记
+	ERROR       // 无效字符错误
 };
 
 unordered_map<string,string> rectifyTokens = {
@@ -39,12 +172,12 @@ unordered_map<string,string> rectifyTokens = {
     {"BEGIN","begin"}, {"END","end"}, {"IF","if"}, {"THEN","then"}, {"ELSE","else"},
     {"WHILE","while"}, {"DO","do"}, {"ODD","odd"}, {"READ","read"}, {"WRITE","write"},
 
-    // ıʽھ滻
-    {"SEMICOLON",";"},  // ; /˵
-    {"COMMA"," ,"},      // , ʶ/ָ
-    {"LPAREN","("},     // ( /ʽͷ
-    {"RPAREN",")"},     // ) /ʽβ
-    {"COLONEQUAL",":="}, // := ֵţ<statement> еĸֵ䣩
+    // 界符和运算符的文本形式（便于纠错替换）
+    {"SEMICOLON",";"},  // ; （语句/说明结束）
+    {"COMMA"," ,"},      // , （多个标识符/常量分隔）
+    {"LPAREN","("},     // ( （参数/表达式开头）
+    {"RPAREN",")"},     // ) （参数/表达式结尾）
+    {"COLONEQUAL",":="}, // := （赋值符号，<statement> 中的赋值语句）
 
 };
 
@@ -52,9 +185,9 @@ struct Token {
 	TokenType type;
 	string value;
 	int row, column;
-	// ĬϹ캯Ա޲γʼ
+	// 保留默认构造函数以便无参初始化
 	Token() : type(TokenType::ERROR), value(""), row(0), column(0) {}
-	//  tokenization.h һµĴι캯
+	// 与 tokenization.h 中一致的带参构造函数
 	Token(TokenType type, const string& value, int row, int column)
 		: type(type), value(value), row(row), column(column) {
 	}
@@ -62,7 +195,7 @@ struct Token {
 };
 
 
-//ӳΪֵַΪӦ TokenTypeƥ䣩
+//类型映射表：键为字符串，值为对应 TokenType（快速匹配）
 unordered_map<string, TokenType> typeMap = {
 	{"PROGRAM" , TokenType::PROGRAM},
 	{"CONST" , TokenType::CONST},
@@ -93,7 +226,7 @@ unordered_map<string, TokenType> typeMap = {
 
 };
 
-//  TokenType תΪɶ֣ڴϢ
+// 将 TokenType 转为可读名字（用于错误消息）
 string tokenTypeName(TokenType t) {
 	switch (t) {
 	case TokenType::PROGRAM: return "PROGRAM";
@@ -113,9 +246,9 @@ string tokenTypeName(TokenType t) {
 	case TokenType::CALL: return "CALL";
 	case TokenType::READ: return "READ";
 	case TokenType::WRITE: return "WRITE";
-	case TokenType::AOP: return "/(+/-)";
-	case TokenType::MOP: return "/(*//)";
-	case TokenType::LOP: return "ϵ(=, <>, <, <=, >, >=)";
+	case TokenType::AOP: return "加/减号(+/-)";
+	case TokenType::MOP: return "乘/除号(*//)";
+	case TokenType::LOP: return "关系运算符(=, <>, <, <=, >, >=)";
 	case TokenType::EOF_TOKEN: return "EOF";
 	default: return "";
 	}
@@ -124,50 +257,50 @@ string tokenTypeName(TokenType t) {
 
 class FirstSet {
 private:
-	// ȷʼ firstSets ӳ䣨ʹͳһĳʼб﷨
+	// 正确初始化 firstSets 映射（使用统一的初始化列表语法）
 	unordered_map<std::string, std::unordered_set<std::string>> firstSets = {
-		// ʼ
+		// 程序起始符号
 		{"<prog>", {"PROGRAM"}},
 
-		// 
+		// 代码块
 		{"<block>", {"CONST", "VAR", "PROCEDURE", "BEGIN"}},
 
-		// 
+		// 常量声明相关
 		{"<condecl_opt>", {"CONST"  }},
 		{"<condecl>", {"CONST"}},
 		{"<const_list>", {"ID"}},
 		{"<const>", {"ID"}},
 		{"<const_list_tail>", {"COMMA" }},
 
-		// 
+		// 变量声明相关
 		{"<vardecl_opt>", {"VAR" }},
 		{"<vardecl>", {"VAR"}},
 
-		// 
+		// 过程声明相关
 		{"<proc_opt>", {"PROCEDURE"}},
 		{"<proc>", {"PROCEDURE"}},
-		{"<param_list_opt>", {"LPAREN"}},  // ѡб
+		{"<param_list_opt>", {"LPAREN"}},  // 可选参数列表
 		{"<id_list_opt>", {"ID"}},
 		{"<proc_tail>", {"SEMICOLON"}},
 
-		// 
+		// 程序体
 		{"<body>", {"BEGIN"}},
 
-		// 
+		// 语句相关
 		{"<statement_list>", {"ID", "IF", "WHILE", "CALL", "BEGIN", "READ", "WRITE"}},
 		{"<statement_tail>", {"SEMICOLON"}},
 		{"<statement>", {"ID", "IF", "WHILE", "CALL", "BEGIN", "READ", "WRITE"}},
 		{"<else_opt>", {"ELSE" }},
 
-		// ѭ
+		// 循环语句
 		{"<while_stmt>", {"WHILE"}},
 
-		// ߼ʽ
+		// 逻辑表达式
 		{"<lexp>", {"ODD", "ID", "INTEGER", "LPAREN", "AOP"}},
 		{"<odd_lexp>", {"ODD"}},
 		{"<cmp_lexp>", {"ID", "INTEGER", "LPAREN", "AOP"}},
 
-		// ʽ
+		// 算术表达式
 		{"<exp>", {"AOP", "ID", "INTEGER", "LPAREN"}},
 		{"<sign_opt>", {"AOP" }},
 		{"<term>", {"ID", "INTEGER", "LPAREN"}},
@@ -175,16 +308,16 @@ private:
 		{"<exp_tail>", {"AOP"}},
 		{"<term_tail>", {"MOP" }},
 
-		// ̵
+		// 过程调用语句
 		{"<call_stmt>", {"CALL"}},
 		{"<arg_list_opt>", {"LPAREN" }},
 
-		// ʽб/ã
+		// 表达式列表（参数/输出用）
 		{"<exp_list_opt>", {"ID", "INTEGER", "LPAREN", "AOP" }},
 		{"<exp_list>", {"ID", "INTEGER", "LPAREN", "AOP"}},
 		{"<exp_list_tail>", {"COMMA" }},
 
-		// 
+		// 输入输出语句
 		{"<read_stmt>", {"READ"}},
 		{"<id_list>", {"ID"}},
 		{"<id_list_tail>", {"COMMA",}},
@@ -192,16 +325,16 @@ private:
 	};
 
 public:
-	// ѡṩȡ First ĽӿڣҪӣ
+	// 可选：提供获取 First 集的接口（根据需要添加）
 	unordered_set<std::string> getFirstSet(const std::string& nonTerminal) const {
 		auto iter = firstSets.find(nonTerminal);
 		if (iter != firstSets.end()) {
 			return iter->second;
 		}
-		// δҵؿռ׳쳣
+		// 若未找到，返回空集（或抛出异常，根据需求调整）
 		return {};
 	}
-	//ӦսFirst
+	//输出对应非终结符的First集
 	void printFirstSet(const string& nonTerminal) {
 		auto iter = firstSets.find(nonTerminal);
 		if (iter != firstSets.end()) {
@@ -216,7 +349,7 @@ public:
 		}
 	}
 
-	//ضӦսFirst
+	//返回对应非终结符的First集
 	vector<string> getFirstSet(const string& nonTerminal) {
 		auto iter = firstSets.find(nonTerminal);
 		if (iter != firstSets.end()) {
@@ -232,9 +365,9 @@ public:
 
 
 
-// ö٣PL/0ֳ֧̣
+// 符号类型枚举（PL/0仅支持常量、变量、过程）
 typedef enum {
-	CONST_SYMBOL,  // 
-	VAR_SYMBOL,    // 
-	PROC_SYMBOL    // 
+	CONST_SYMBOL,  // 常量
+	VAR_SYMBOL,    // 变量
+	PROC_SYMBOL    // 过程
 } SymbolType;
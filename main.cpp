@@ -3,15 +3,55 @@
 #include<fstream>
 #include"tokenization.h"
 #include"Parser.h"
+#include"RegVM.h"
+#include"JIT.h"
+#include"CBackend.h"
 
 using namespace std;
 
 int main(int argc,char* argv[])
 {
-	if (argc == 3) {
-		tokenizationer Plexer(argv[1], argv[2]);
+	//选项：-O0 关闭全部优化；-fno-<规则名> 关闭某条窥孔规则；-emit-c=<文件> 同时输出C源文件
+	//-fno-super 关闭超级指令；-super-profile=<剖析文件> -super-top=<N> 按剖析结果只启用前N种
+	//其余解释器选项见 config.h 中的 vmOption
+	vector<string> args;
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (arg == "-O0") {
+			fold_mode = false;
+			dce_mode = false;
+			peephole_mode = false;
+			super_mode = false;
+		}
+		else if (arg == "-fno-super") {
+			super_mode = false;
+		}
+		else if (arg.rfind("-super-profile=", 0) == 0) {
+			super_profile = arg.substr(15);
+		}
+		else if (arg.rfind("-super-top=", 0) == 0) {
+			super_top = atoi(arg.c_str() + 11);
+		}
+		else if (arg.rfind("-emit-c=", 0) == 0) {
+			emit_c = arg.substr(8);
+		}
+		else if (vmOption(arg)) {
+			//解释器选项，与 pl0vm 共用
+		}
+		else if (arg.rfind("-fno-", 0) == 0) {
+			peephole_off.insert(arg.substr(5));
+		}
+		else {
+			args.push_back(arg);
+		}
+	}
+	if (args.size() == 2 && profile_src.empty()) profile_src = args[0];//剖析按编译的源文件标注
+	vmOptionsDone();
+
+	if (args.size() == 2) {
+		tokenizationer Plexer(args[0], args[1]);
 		Plexer.tokenize();
-		Parser paser(argv[2]);
+		Parser paser(args[1]);
 		paser.parse();
 
 	}
@@ -22,9 +62,34 @@ int main(int argc,char* argv[])
 		paser.parse();
 	}
 
+	if (!emit_c.empty()) {
+		DebugInfo dbg;
+		CBackend backend;
+		if (!pcode.loadProgram("pcode.txt", dbg) || !backend.emit(pcode, dbg, emit_c)) return 1;
+	}
+
 	//
-	cout << "\n\nִpcode..." << endl;
-	pcode.interpret(symTable, "pcode.txt");
-	cout << "\n\n¼ջpcode_output.txtļв鿴 main.pyչʾ" << endl;
-	return 0;
+	cout << "\n\n解释执行pcode..." << endl;
+	if (regvm_mode) {
+		interpretRegVM(pcode, "pcode.txt");
+	}
+	else if (jit_mode) {
+		interpretJIT(pcode, "pcode.txt");
+	}
+	else if (tier_mode) {
+		interpretTiered(pcode, "pcode.txt");
+	}
+	else {
+		pcode.interpret("pcode.txt");//只依赖pcode.txt及其调试信息文件pcode.dbg
+	}
+	if (trace_mode && trace_binary) {
+		cout << "\n\n执行轨迹已输出到pcode_trace.bin，运行 python trace2txt.py 还原为pcode_output.txt后可用main.py展示" << endl;
+	}
+	else if (trace_mode) {
+		cout << "\n\n活动记录栈可在pcode_output.txt文件中查看； 或者运行main.py程序展示动画过程" << endl;
+	}
+	else {
+		cout << "\n\n使用 -trace 选项可输出活动记录栈到pcode_output.txt文件" << endl;
+	}
+	return runtime_failed ? 1 : 0;
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include<iostream>
+#include<string>
+#include<chrono>
+#include"Pcode.h"
+#include"RegVM.h"
+#include"JIT.h"
+
+using namespace std;
+
+/*
+独立虚拟机：直接加载编译器输出的二进制映像 pcode.img 执行，不经过词法、语法分析
+用法：pl0vm [映像文件] [解释器选项]，映像文件默认为 pcode.img，选项见 config.h 中的 vmOption
+*/
+int main(int argc, char* argv[])
+{
+	string file = "pcode.img";
+	for (int i = 1; i < argc; i++) {
+		string arg = argv[i];
+		if (vmOption(arg)) continue;
+		if (!arg.empty() && arg[0] == '-') {
+			cerr << "未知选项: " << arg << endl;
+			return 1;
+		}
+		file = arg;
+	}
+	vmOptionsDone();
+
+	auto start = chrono::steady_clock::now();
+	Pcode vm;
+	DebugInfo dbg;
+	if (!vm.loadProgram(file, dbg)) return 1;
+	if (stats_mode) {
+		double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		cout << "加载 " << file << "：指令 " << vm.code.size() << " 条，用时 " << sec * 1000 << " 毫秒" << endl;
+	}
+
+	if (regvm_mode) {
+		interpretRegVM(vm, dbg);
+	}
+	else if (jit_mode) {
+		interpretJIT(vm, dbg);
+	}
+	else if (tier_mode) {
+		interpretTiered(vm, dbg);
+	}
+	else {
+		vm.interpret(dbg);
+	}
+	return runtime_failed ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+import argparse
+import re
+import sys
+from collections import Counter
+
+# -------------------------- 指令序列频度统计 --------------------------
+# 从解释器输出的执行轨迹（pcode_output.txt 格式）中统计连续执行的指令序列，
+# 结果写入剖析文件，供编译器 -super-profile=文件 选择要融合的超级指令。
+# 序列只在顺序执行的指令间统计：发生跳转（下一条地址不是当前地址+1）即断开，
+# 因为只有直线代码才能静态融合。
+
+INS_RE = re.compile(r'^(\d+):\s+([A-Z]+)\s+(-?\d+)\s+(-?\d+)\s*$')
+
+
+def ins_key(name, L, A):
+    """指令的统计键：OPR 按子操作区分，比较后条件跳转按比较码区分"""
+    if name == 'OPR':
+        return f'OPR:{A}'
+    if name == 'JPC' and L != 0:
+        return f'JPC:{L}'
+    return name
+
+
+def read_trace(file_path):
+    """按执行顺序返回 (地址, 统计键) 列表，自动适配utf-8/gbk编码"""
+    for enc in ('utf-8', 'gbk'):
+        try:
+            with open(file_path, 'r', encoding=enc) as f:
+                lines = f.readlines()
+            break
+        except UnicodeDecodeError:
+            continue
+    else:
+        raise Exception(f"文件编码不支持：{file_path}")
+
+    steps = []
+    for line in lines:
+        m = INS_RE.match(line.strip())
+        if m:
+            pc, name, L, A = int(m.group(1)), m.group(2), int(m.group(3)), int(m.group(4))
+            steps.append((pc, ins_key(name, L, A)))
+    return steps
+
+
+def mine(steps, max_len, counter):
+    """统计长度2..max_len的顺序执行序列"""
+    run = []  # 当前直线段内最近的统计键
+    last_pc = None
+    for pc, key in steps:
+        if last_pc is None or pc != last_pc + 1:
+            run = []
+        run.append(key)
+        if len(run) > max_len:
+            run.pop(0)
+        for n in range(2, len(run) + 1):
+            counter[tuple(run[-n:])] += 1
+        last_pc = pc
+
+
+def main():
+    parser = argparse.ArgumentParser(description='统计执行轨迹中的指令序列频度')
+    parser.add_argument('traces', nargs='+', help='执行轨迹文件（pcode_output.txt 格式）')
+    parser.add_argument('-n', type=int, default=4, help='最长序列长度，默认4')
+    parser.add_argument('-top', type=int, default=20, help='输出前N个序列，默认20')
+    parser.add_argument('-o', default='superops.txt', help='剖析文件，默认 superops.txt')
+    args = parser.parse_args()
+
+    counter = Counter()
+    total = 0
+    for path in args.traces:
+        steps = read_trace(path)
+        total += len(steps)
+        mine(steps, args.n, counter)
+
+    ranked = counter.most_common()
+    print(f"共 {total} 步，{len(ranked)} 种序列")
+    for seq, cnt in ranked[:args.top]:
+        print(f"{cnt:>10}  {' '.join(seq)}")
+
+    # 剖析文件：每行 次数 序列，按次数降序
+    with open(args.o, 'w', encoding='utf-8') as f:
+        for seq, cnt in ranked:
+            f.write(f"{cnt} {' '.join(seq)}\n")
+    print(f"剖析结果已输出到文件,{args.o}")
+
+
+if __name__ == '__main__':
+    sys.exit(main())
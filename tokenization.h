@@ -1,6 +1,6 @@
 
 /*
-ʷTokenizer/Lexical Analyzer
+词法分析器（Tokenizer/Lexical Analyzer）
 */
 
 #pragma once
@@ -19,10 +19,10 @@ class tokenizationer
 private:
 	ifstream srcFile;
 	ofstream outFile;
-	int currentChar; // ʹ int ȷʾ EOF
+	int currentChar; // 使用 int 以正确表示 EOF
 	int row, column;
 
-	// ؼӳΪСдؼֵ֣ΪӦ TokenTypeƥ䣩
+	// 关键字映射表：键为小写关键字，值为对应 TokenType（快速匹配）
 	unordered_map<string, TokenType> keywordMap = {
 		{"program", TokenType::PROGRAM},
 		{"const", TokenType::CONST},
@@ -48,11 +48,11 @@ public:
 		outFile.open(outPath);
 
 		if (!srcFile.is_open()) {
-			cerr << "Դļ" << srcPath << "ʧ" << endl;
+			cerr << "源文件" << srcPath << "打开失败" << endl;
 			exit(1);
 		}
 		if (!outFile.is_open()) {
-			cerr << "ļ" << outPath << "ʧ" << endl;
+			cerr << "输出文件" << outPath << "打开失败" << endl;
 			exit(1);
 		}
 
@@ -80,10 +80,10 @@ public:
 		}
 		currentChar = c;
 
-		// λã column ʾ currentChar У1ʼ
+		// 更新位置： column 表示 currentChar 的列（从1开始）
 		if (currentChar == '\n') {
 			row++;
-			column = 0; // նУһ nextchar()  column Ϊ 1
+			column = 0; // 刚读到换行，下一次 nextchar() 会把 column 设为 1
 		}
 		else {
 			column++;
@@ -103,8 +103,8 @@ public:
 		}
 
 		string token = "";
-		if (std::isalpha(static_cast<unsigned char>(currentChar))) { // ؼֻʶ
-			// ¼ʼλ
+		if (std::isalpha(static_cast<unsigned char>(currentChar))) { // 关键字或标识符
+			// 记录起始位置
 			int startrow = row;
 			int startcolumn = column;
 
@@ -114,20 +114,20 @@ public:
 			}
 
 			auto it = keywordMap.find(token);
-			if (it != keywordMap.end()) { // ؼ
+			if (it != keywordMap.end()) { // 关键字
 				return Token(it->second, token, startrow, startcolumn);
 			}
-			else { // ʶ
+			else { // 标识符
 				return Token(TokenType::IDENTIFIER, token, startrow, startcolumn);
 			}
 		}
-		else if (std::isdigit(static_cast<unsigned char>(currentChar))) { // 
+		else if (std::isdigit(static_cast<unsigned char>(currentChar))) { // 数字
 			int startrow = row;
 			int startcolumn = column;
 
 			while (currentChar != EOF && !std::isspace(static_cast<unsigned char>(currentChar))) {
 				if (std::isalpha(static_cast<unsigned char>(currentChar))) {
-					// ĸ 12a
+					// 包含字母，错误（例如 12a）
 					token.push_back(static_cast<char>(currentChar));
 					nextchar();
 					return Token(TokenType::ERROR, token, startrow, startcolumn);
@@ -143,13 +143,13 @@ public:
 			return Token(TokenType::INTEGER, token, startrow, startcolumn);
 		}
 		else {
-			// ¼ʼλ
+			// 记录起始位置
 			int startrow = row;
 			int startcolumn = column;
 			string lexeme = "";
 
 			switch (currentChar) {
-				// . , ; (  ) 
+				// 界符. , ; (  ) 
 			case ',':
 				lexeme = ",";
 				nextchar();
@@ -167,7 +167,7 @@ public:
 				nextchar();
 				return Token(TokenType::RPAREN, lexeme, startrow, startcolumn);
 
-				//  aop
+				// 运算符 aop
 			case '+':
 			case '-':
 				lexeme = static_cast<char>(currentChar);
@@ -181,7 +181,7 @@ public:
 				nextchar();
 				return Token(TokenType::MOP, lexeme, startrow, startcolumn);
 
-				// ϵ lop  =<><<=>>=
+				// 关系运算符 lop  =、<>、<、<=、>、>=
 			case '=':
 				lexeme = "=";
 				nextchar();
@@ -207,7 +207,7 @@ public:
 				}
 				return Token(TokenType::LOP, lexeme, startrow, startcolumn);
 
-				// ֵ :=
+				// 赋值界符 :=
 			case ':':
 				lexeme = ":";
 				nextchar();
@@ -229,8 +229,8 @@ public:
 	}
 
 	void printtoken(Token token) {
-		// ͳһʽTYPE(value)(row,column) 
-		//  TYPEдöӦַ
+		// 输出统一格式：TYPE(value)(row,column) 
+		// 先输出 TYPE（大写枚举名对应字符串）
 		switch (token.type)
 		{
 		case TokenType::PROGRAM:    outFile << "PROGRAM"; break;
@@ -265,10 +265,10 @@ public:
 			break;
 		}
 
-		// Ȼ (value)
+		// 然后输出 (value)
 		outFile << "(" << token.value << ")";
 
-		//  (row,column)
+		// 最后输出 (row,column)
 		outFile << "(" << token.row << "," << token.column << ")" << endl;
 	}
 
@@ -277,21 +277,21 @@ public:
 		Token token = gettoken();
 		while (token.type != TokenType::EOF_TOKEN) {
 			if (token.type == TokenType::ERROR) {
-				cerr << "ERROR(Чַ: '" << token.value << "')"
+				cerr << "ERROR(无效字符: '" << token.value << "')"
 					<< "(" << token.row << "," << token.column << ")" << endl;
 				exit(1);
 			}
 			printtoken(token);
 			token = gettoken();
 		}
-		cout << "\nʷȫToken ѱ浽мļoutTokens.txt" << endl;
+		cout << "\n词法分析的全部Token 结果已保存到中间文件outTokens.txt中" << endl;
 
 
 	}
 
-	// ӵǰȡ token  tokensɶεãλû
-	// Լcount > 0 => ȡ count count <= 0 => ȡֱ EOF
-	void getTokens(int count, vector<Token>& tokens) {//ȡcounttoken,浽tokens
+	// 从当前输入流连续读取 token 到 tokens（解析器可多次调用，流位置会继续）
+	// 约定：count > 0 => 读取最多 count 个；count <= 0 => 读取直到 EOF
+	void getTokens(int count, vector<Token>& tokens) {//获取count个token,存到tokens里
 		tokens.clear();
 
 		bool toEOF = (count <= 0);
@@ -306,8 +306,8 @@ public:
 			read++;
 
 			if (t.type == TokenType::ERROR) {
-				// ӡ󣬽ɵ÷ڴ exit
-				cerr << "ERROR(Чַ: '" << t.value << "')"
+				// 打印错误，交由调用方决定后续处理（不在此 exit）
+				cerr << "ERROR(无效字符: '" << t.value << "')"
 					<< "(" << t.row << "," << t.column << ")" << endl;
 				break;
 			}
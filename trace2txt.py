@@ -0,0 +1,136 @@
+import argparse
+import struct
+import sys
+
+# -------------------------- 二进制轨迹还原 --------------------------
+# 把解释器 -trace=bin 输出的 pcode_trace.bin 还原为 -trace 的文本格式（pcode_output.txt），
+# 供 main.py 展示。文件格式见 Trace.h。
+
+STEP, CALL, BACK, STACK = 1, 2, 3, 4
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def eof(self):
+        return self.pos >= len(self.data)
+
+    def u8(self):
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def u32(self):
+        v = struct.unpack_from('<I', self.data, self.pos)[0]
+        self.pos += 4
+        return v
+
+    def i32(self):
+        v = struct.unpack_from('<i', self.data, self.pos)[0]
+        self.pos += 4
+        return v
+
+    def string(self):
+        n = self.u32()
+        s = self.data[self.pos:self.pos + n].decode('utf-8', errors='replace')
+        self.pos += n
+        return s
+
+    def var(self):
+        """LEB128 无符号变长整数"""
+        v = 0
+        shift = 0
+        while True:
+            b = self.data[self.pos]
+            self.pos += 1
+            v |= (b & 0x7f) << shift
+            if b < 0x80:
+                return v
+            shift += 7
+
+    def svar(self):
+        """zigzag 编码的有符号变长整数"""
+        v = self.var()
+        return (v >> 1) ^ -(v & 1)
+
+
+def convert(data, out):
+    r = Reader(data)
+    if data[:4] != b'PL0T':
+        raise Exception('不是二进制轨迹文件（magic 不符）')
+    r.pos = 4
+    version = r.u32()
+    if version != 1:
+        raise Exception(f'不支持的轨迹版本：{version}')
+
+    code = []
+    for _ in range(r.u32()):
+        name = r.string()
+        L = r.i32()
+        A = r.i32()
+        code.append(f'{name} {L} {A}')
+    procs = []
+    for _ in range(r.u32()):
+        name = r.string()
+        ids = [r.string() for _ in range(r.u32())]
+        procs.append((name, ids))
+
+    stack = []               # 与解释器一致的栈内容（只按记录更新）
+    top = 0
+    frames = [(0, procs[0])]  # (基址, 过程)，用于给ID区标注名字
+
+    def slot_text(i, frame):
+        while frame > 0 and frames[frame][0] > i:
+            frame -= 1
+        base, (_, ids) = frames[frame]
+        k = i - base - 4
+        if 0 <= k < len(ids):
+            return f'{ids[k]}:{stack[i]}', frame
+        return str(stack[i]), frame
+
+    while not r.eof():
+        tag = r.u8()
+        if tag == STEP:
+            pc = r.var()
+            out.write(f'{pc}: {code[pc]}\n')
+        elif tag == CALL:
+            proc = r.var()
+            base = r.var()
+            frames.append((base, procs[proc]))
+            out.write(f'\nnewAc:{procs[proc][0]}\n')
+        elif tag == BACK:
+            layer = r.var()
+            frames.pop()
+            out.write(f'\nback {layer}\n')
+        elif tag == STACK:
+            top = r.var()
+            if len(stack) < top:
+                stack.extend([0] * (top - len(stack)))
+            for _ in range(r.var()):
+                i = r.var()
+                stack[i] = r.svar()
+            frame = len(frames) - 1
+            for i in range(top - 1, -1, -1):
+                text, frame = slot_text(i, frame)
+                out.write(f'[{i}]: {text}\n')
+        else:
+            raise Exception(f'轨迹记录标记错误：{tag}（偏移 {r.pos - 1}）')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='二进制执行轨迹还原为 pcode_output.txt 文本格式')
+    parser.add_argument('input', nargs='?', default='pcode_trace.bin', help='二进制轨迹，默认 pcode_trace.bin')
+    parser.add_argument('-o', default='pcode_output.txt', help='输出文件，默认 pcode_output.txt')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    with open(args.o, 'w', encoding='utf-8', newline='\n') as out:
+        convert(data, out)
+    print(f"轨迹已还原到文件,{args.o}")
+
+
+if __name__ == '__main__':
+    sys.exit(main())
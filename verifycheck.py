@@ -0,0 +1,128 @@
+import argparse
+import os
+import re
+import struct
+import subprocess
+import sys
+import tempfile
+import shutil
+
+# -------------------------- 加载校验测试 --------------------------
+# 解释器主循环依赖加载时的校验省去地址和栈检查，畸形的 pcode.txt / pcode.dbg 必须在加载时被拒绝，
+# 不能在执行中越界写内存而崩溃。本脚本编译一个带参数过程的小程序，逐项篡改其输出后用 pl0vm 加载，
+# 要求报告"校验失败"或"格式错误"并以退出码1结束；未篡改的原文件须正常执行。
+
+SOURCE = """program vc;
+var r;
+  procedure add(a, b);
+  begin
+    r := a + b
+  end
+begin
+  call add(3, 4);
+  write(r)
+end
+"""
+
+STO_ARG_RE = re.compile(r'^(\d+): STO -1 (\d+)$', re.M)
+
+
+def decode(data):
+    """输出自动适配utf-8/gbk编码"""
+    for enc in ('utf-8', 'gbk'):
+        try:
+            return data.decode(enc)
+        except UnicodeDecodeError:
+            continue
+    return data.decode('utf-8', errors='replace')
+
+
+def patch_sto_arg(text, dbg):
+    """第一条 STO -1 的实参偏移改为远超形参区"""
+    return STO_ARG_RE.sub(lambda m: f'{m.group(1)}: STO -1 100000000', text, count=1), dbg
+
+
+def patch_sto_extra(text, dbg):
+    """第二条 STO -1 的偏移改为形参个数，恰好越过形参区"""
+    n = [0]
+
+    def sub(m):
+        n[0] += 1
+        return f'{m.group(1)}: STO -1 2' if n[0] == 2 else m.group(0)
+    return STO_ARG_RE.sub(sub, text), dbg
+
+
+def layout_field(dbg, proc, field, value):
+    """改写旁路文件布局中下标为proc的过程的第field项（entry level parent param_count id_count）"""
+    b = bytearray(dbg)
+    struct.pack_into('<i', b, 12 + proc * 20 + field * 4, value)
+    return bytes(b)
+
+
+CASES = [
+    ('实参偏移远超形参区', patch_sto_arg, '校验失败'),
+    ('实参偏移恰好越过形参区', patch_sto_extra, '校验失败'),
+    ('ID个数过大', lambda t, d: (t, layout_field(d, 1, 4, 2000000000)), '格式错误'),
+    ('过程层与外层过程不符', lambda t, d: (t, layout_field(d, 1, 1, 5)), '格式错误'),
+]
+
+
+def run_vm(pl0vm, work, name):
+    proc = subprocess.run([pl0vm, name + '.txt'], cwd=work, stdin=subprocess.DEVNULL,
+                          stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    return proc.returncode, decode(proc.stdout) + decode(proc.stderr)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description='畸形 pcode.txt / pcode.dbg 须在加载时被拒绝')
+    parser.add_argument('--pl0', default=os.path.join(here, 'pl0'), help='编译器可执行文件，默认 ./pl0')
+    parser.add_argument('--pl0vm', default=os.path.join(here, 'pl0vm'), help='独立虚拟机，默认 ./pl0vm')
+    args = parser.parse_args()
+    pl0, pl0vm = os.path.abspath(args.pl0), os.path.abspath(args.pl0vm)
+    for p in (pl0, pl0vm):
+        if not os.path.isfile(p):
+            print(f"找不到可执行文件：{p}", file=sys.stderr)
+            return 1
+
+    work = tempfile.mkdtemp(prefix='pl0v')
+    failures = 0
+    try:
+        with open(os.path.join(work, 'pascal.txt'), 'w') as f:
+            f.write(SOURCE)
+        subprocess.run([pl0], cwd=work, stdin=subprocess.DEVNULL, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+        with open(os.path.join(work, 'pcode.txt'), 'rb') as f:
+            text = decode(f.read())
+        with open(os.path.join(work, 'pcode.dbg'), 'rb') as f:
+            dbg = f.read()
+        if not STO_ARG_RE.search(text):
+            print('编译结果中没有 STO -1 指令，无法测试', file=sys.stderr)
+            return 1
+
+        code, out = run_vm(pl0vm, work, 'pcode')
+        ok = code == 0 and '输出: 7' in out
+        print(f"{'通过' if ok else '失败'}  未篡改的程序正常执行")
+        failures += not ok
+
+        for k, (title, patch, expect) in enumerate(CASES):
+            name = f'case{k}'
+            t, d = patch(text, dbg)
+            with open(os.path.join(work, name + '.txt'), 'w', encoding='utf-8', newline='\n') as f:
+                f.write(t)
+            with open(os.path.join(work, name + '.dbg'), 'wb') as f:
+                f.write(d)
+            code, out = run_vm(pl0vm, work, name)
+            # 退出码为负表示被信号终止（如越界写内存），134为abort
+            ok = code == 1 and expect in out
+            print(f"{'通过' if ok else '失败'}  {title}：退出码 {code}")
+            if not ok:
+                print('  ' + out.strip().replace('\n', '\n  '))
+            failures += not ok
+    finally:
+        shutil.rmtree(work, ignore_errors=True)
+    print(f"共 {len(CASES) + 1} 项，{failures} 项失败")
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())